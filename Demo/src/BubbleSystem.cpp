@@ -56,6 +56,8 @@ BubbleSystem::BubbleSystem(xy::MessageBus& mb, xy::NetHost& host)
     requireComponent<Actor>();
     requireComponent<Bubble>();
     requireComponent<CollisionComponent>();
+
+    subscribe(MessageID::PlayerMessage);
 }
 
 //public
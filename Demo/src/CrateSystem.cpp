@@ -66,6 +66,8 @@ CrateSystem::CrateSystem(xy::MessageBus& mb, xy::NetHost& nh)
     requireComponent<xy::Transform>();
 
     m_waveTable = xy::Util::Wavetable::sine(8.f, 1.2f);
+
+    subscribe(MessageID::MapMessage);
 }
 
 //public
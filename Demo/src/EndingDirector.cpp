@@ -101,6 +101,9 @@ EndingDirector::EndingDirector(xy::SoundResource& ar, xy::TextureResource& tr, x
     m_messageBus        (mb)
 {
     m_spriteSheet.loadFromFile("assets/sprites/ending_food.spt", m_textureResource);
+
+    subscribe(Messages::SpriteMessage);
+    subscribe(Messages::SpeechMessage);
 }
 
 //public
@@ -59,6 +59,11 @@ FXDirector::FXDirector()
     m_soundResource.get("assets/sound/crate_break.wav");
     m_soundResource.get("assets/sound/one_up.wav");
     m_soundResource.get("assets/sound/explode.wav");
+
+    subscribe(MessageID::PlayerMessage);
+    subscribe(MessageID::SceneMessage);
+    subscribe(MessageID::AnimationMessage);
+    subscribe(MessageID::MapMessage);
 }
 
 //public
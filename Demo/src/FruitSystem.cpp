@@ -48,6 +48,8 @@ FruitSystem::FruitSystem(xy::MessageBus& mb, xy::NetHost& host)
     requireComponent<CollisionComponent>();
     requireComponent<xy::Transform>();
     requireComponent<Fruit>();
+
+    subscribe(MessageID::SceneMessage);
 }
 
 //public
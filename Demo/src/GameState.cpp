@@ -311,6 +311,9 @@ bool GameState::update(float dt)
 {   
     DPRINT("map", m_mapData.mapName);
     DPRINT("Actor count", std::to_string(debugActorCount));
+    DPRINT("Draw calls", std::to_string(m_scene.getSystem<xy::RenderSystem>().getDrawCallCount())
+        + " (" + std::to_string(m_scene.getSystem<xy::RenderSystem>().getVisibleCount()) + " drawables)");
+    DPRINT("Vertices", std::to_string(m_scene.getSystem<xy::RenderSystem>().getVertexCount()));
     //DPRINT("Actor Update Count", std::to_string(debugActorUpdate));
     //DPRINT("Player Server State", std::to_string(debugPlayerState));
     //DPRINT("Crown Vel", std::to_string(debugCrownVel.x) + ", " + std::to_string(debugCrownVel.y));
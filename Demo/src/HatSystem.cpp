@@ -61,6 +61,9 @@ HatSystem::HatSystem(xy::MessageBus& mb, xy::NetHost& host)
     requireComponent<xy::Transform>();
     requireComponent<CollisionComponent>();
     requireComponent<AnimationController>();
+
+    subscribe(MessageID::PlayerMessage);
+    subscribe(MessageID::MapMessage);
 }
 
 //public
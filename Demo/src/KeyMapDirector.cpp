@@ -45,6 +45,8 @@ KeyMapDirector::KeyMapDirector(SharedStateData& ssd, xy::ConfigFile& cfg)
 {
     m_cfgName = xy::FileSystem::getConfigDirectory(dataDir);
     m_cfgName += "keybinds.cfg";
+
+    subscribe(MessageID::MenuMessage);
 }
 
 
@@ -75,6 +75,8 @@ NPCSystem::NPCSystem(xy::MessageBus& mb, xy::NetHost& host)
     requireComponent<CollisionComponent>();
     requireComponent<xy::Transform>();
     requireComponent<AnimationController>();
+
+    subscribe(MessageID::NpcMessage);
 }
 
 //public
@@ -52,6 +52,9 @@ ParticleDirector::ParticleDirector(xy::TextureResource& tr)
     m_settings[SettingsID::SpawnNPC].loadFromFile("assets/particles/spawn.xyp", tr);
     m_settings[SettingsID::BreakCrate].loadFromFile("assets/particles/crate.xyp", tr);
     m_settings[SettingsID::Explosion].loadFromFile("assets/particles/explode.xyp", tr);
+
+    subscribe(MessageID::SceneMessage);
+    subscribe(MessageID::AnimationMessage);
 }
 
 //public
@@ -0,0 +1,135 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include "Benchmark.hpp"
+
+#include <xyginext/core/JobSystem.hpp>
+#include <xyginext/ecs/Entity.hpp>
+
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+#include <iomanip>
+
+namespace
+{
+    //names are all generated here, but escape them anyway
+    std::string escape(const std::string& str)
+    {
+        std::string retVal;
+        for (auto c : str)
+        {
+            if (c == '"' || c == '\\')
+            {
+                retVal.push_back('\\');
+            }
+            retVal.push_back(c);
+        }
+        return retVal;
+    }
+}
+
+BenchmarkRunner::BenchmarkRunner()
+    : m_iterations(10)
+{
+
+}
+
+//public
+void BenchmarkRunner::run(const std::string& name, std::size_t count, const std::function<void()>& func, const std::function<void()>& setup)
+{
+    const auto fullName = name + "/" + std::to_string(count);
+    if (!m_filter.empty() && fullName.find(m_filter) == std::string::npos)
+    {
+        return;
+    }
+
+    //warm up
+    if (setup) setup();
+    func();
+
+    std::vector<double> times;
+    times.reserve(m_iterations);
+    for (auto i = 0u; i < m_iterations; ++i)
+    {
+        if (setup) setup();
+
+        auto start = std::chrono::steady_clock::now();
+        func();
+        auto end = std::chrono::steady_clock::now();
+
+        times.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    std::sort(times.begin(), times.end());
+
+    Result result;
+    result.name = fullName;
+    result.count = count;
+    result.iterations = times.size();
+    if (!times.empty())
+    {
+        result.min = times.front();
+        result.max = times.back();
+        result.median = times[times.size() / 2];
+        result.mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+    }
+    m_results.push_back(result);
+
+    std::cerr << std::left << std::setw(40) << fullName << " median " << std::fixed << std::setprecision(3) << result.median << "ms\n";
+}
+
+void BenchmarkRunner::writeJson(std::ostream& stream) const
+{
+    const auto workerCount = xy::JobSystem::getActiveWorkerCount();
+
+    stream << "{\n";
+    stream << "  \"version\": 1,\n";
+#ifdef XY_DEBUG
+    stream << "  \"build\": \"Debug\",\n";
+#else
+    stream << "  \"build\": \"Release\",\n";
+#endif
+    stream << "  \"entityHandleBits\": " << (sizeof(xy::Entity::Handle) * 8) << ",\n";
+    stream << "  \"workers\": " << workerCount << ",\n";
+    stream << "  \"results\": [";
+
+    stream << std::setprecision(6);
+    for (auto i = 0u; i < m_results.size(); ++i)
+    {
+        const auto& result = m_results[i];
+        stream << (i == 0 ? "\n" : ",\n");
+        stream << "    { \"name\": \"" << escape(result.name) << "\""
+            << ", \"count\": " << result.count
+            << ", \"iterations\": " << result.iterations
+            << ", \"min_ms\": " << result.min
+            << ", \"median_ms\": " << result.median
+            << ", \"mean_ms\": " << result.mean
+            << ", \"max_ms\": " << result.max << " }";
+    }
+    stream << "\n  ]\n}\n";
+}
@@ -0,0 +1,101 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_BENCHMARK_HPP_
+#define XY_BENCHMARK_HPP_
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <ostream>
+#include <array>
+
+/*!
+\brief Runs and times a set of benchmarks.
+Each benchmark is run once to warm up, then the given number of
+times, with an optional setup function called before each run
+which isn't included in the timings. Results are written as JSON
+so that they can be compared between builds.
+*/
+class BenchmarkRunner final
+{
+public:
+    struct Result final
+    {
+        std::string name;
+        std::size_t count = 0; //number of items processed by each run, such as entities
+        std::size_t iterations = 0;
+        double min = 0.0; //all times in milliseconds
+        double median = 0.0;
+        double mean = 0.0;
+        double max = 0.0;
+    };
+
+    BenchmarkRunner();
+
+    /*!
+    \brief Only benchmarks whose name contains this string are run
+    */
+    void setFilter(const std::string& filter) { m_filter = filter; }
+
+    /*!
+    \brief Sets the number of timed runs of each benchmark
+    */
+    void setIterations(std::size_t iterations) { m_iterations = iterations; }
+
+    /*!
+    \brief Times the given function.
+    \param name Name of the benchmark, written to the results as "name/count"
+    \param count Number of items processed by the benchmark
+    \param func Function to time
+    \param setup Optional function called before each run of func, not timed.
+    Neither function is called if the benchmark doesn't pass the filter, so
+    any expensive preparation shared between benchmarks can be done lazily
+    on the first call to setup.
+    */
+    void run(const std::string& name, std::size_t count, const std::function<void()>& func, const std::function<void()>& setup = nullptr);
+
+    const std::vector<Result>& getResults() const { return m_results; }
+
+    /*!
+    \brief Writes the results and some information about the build as JSON
+    */
+    void writeJson(std::ostream&) const;
+
+private:
+    std::string m_filter;
+    std::size_t m_iterations;
+    std::vector<Result> m_results;
+};
+
+//entity counts used by the benchmarks which scale with the size of a scene
+static const std::array<std::size_t, 3u> EntityCounts = { 1000u, 10000u, 100000u };
+
+void runCoreBenchmarks(BenchmarkRunner&);
+void runSystemBenchmarks(BenchmarkRunner&);
+
+#endif //XY_BENCHMARK_HPP_
@@ -0,0 +1,395 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//micro benchmarks of the scene, components, message bus and config files
+
+#include "Benchmark.hpp"
+#include "TestScene.hpp"
+
+#include <xyginext/core/MessageBus.hpp>
+#include <xyginext/core/ConfigFile.hpp>
+#include <xyginext/core/JobSystem.hpp>
+#include <xyginext/ecs/Scene.hpp>
+#include <xyginext/ecs/Prefab.hpp>
+#include <xyginext/ecs/Snapshot.hpp>
+#include <xyginext/ecs/components/Transform.hpp>
+
+#include <memory>
+#include <cstdio>
+
+namespace
+{
+    //the same data in each type of pool
+    struct DenseData final
+    {
+        float x = 0.f, y = 0.f, vx = 1.f, vy = 1.f;
+    };
+
+    struct SparseData final
+    {
+        float x = 0.f, y = 0.f, vx = 1.f, vy = 1.f;
+    };
+
+    struct ChunkedData final
+    {
+        float x = 0.f, y = 0.f, vx = 1.f, vy = 1.f;
+    };
+}
+
+namespace xy
+{
+    template <>
+    struct UseSparseStorage<SparseData> : std::true_type {};
+
+    template <>
+    struct UseChunkedStorage<ChunkedData> : std::true_type {};
+
+    template <>
+    struct ComponentSerialiser<DenseData> : ByteSerialiser<DenseData> {};
+
+    template <>
+    struct ComponentSerialiser<SparseData> : ByteSerialiser<SparseData> {};
+
+    template <>
+    struct ComponentSerialiser<ChunkedData> : ByteSerialiser<ChunkedData> {};
+}
+
+namespace
+{
+    struct BenchMessage final
+    {
+        sf::Uint32 value = 0;
+        float x = 0.f, y = 0.f;
+    };
+
+    //stops the optimiser removing work whose result is otherwise unused
+    volatile float sink = 0.f;
+
+    void populate(TestScene& test, std::size_t count)
+    {
+        test.reset();
+        test.entities.reserve(count);
+        for (auto i = 0u; i < count; ++i)
+        {
+            auto entity = test.scene->createEntity();
+            entity.addComponent<xy::Transform>().setPosition(static_cast<float>(i % 1000), static_cast<float>(i / 1000));
+            entity.addComponent<DenseData>();
+            entity.addComponent<SparseData>();
+            entity.addComponent<ChunkedData>();
+            test.entities.push_back(entity);
+        }
+        test.update();
+    }
+
+    void entityBenchmarks(BenchmarkRunner& runner)
+    {
+        TestScene test;
+        for (auto count : EntityCounts)
+        {
+            runner.run("entity.create", count,
+                [&]()
+            {
+                for (auto i = 0u; i < count; ++i)
+                {
+                    test.scene->createEntity();
+                }
+            },
+                [&]() { test.reset(); });
+
+            runner.run("entity.destroy", count,
+                [&]()
+            {
+                for (auto entity : test.entities)
+                {
+                    test.scene->destroyEntity(entity);
+                }
+                test.update();
+            },
+                [&]() { populate(test, count); });
+
+            //entities are added to systems when the scene is next updated
+            runner.run("scene.addToSystems", count,
+                [&]()
+            {
+                test.update();
+            },
+                [&]()
+            {
+                test.reset();
+                for (auto i = 0u; i < count; ++i)
+                {
+                    auto entity = test.scene->createEntity();
+                    entity.addComponent<xy::Transform>();
+                    entity.addComponent<DenseData>();
+                }
+            });
+        }
+    }
+
+    void componentBenchmarks(BenchmarkRunner& runner)
+    {
+        const std::size_t lookupCount = 1000000;
+        runner.run("component.getID", lookupCount,
+            [lookupCount]()
+        {
+            std::size_t total = 0;
+            for (auto i = 0u; i < lookupCount; ++i)
+            {
+                total += xy::Component::getID<DenseData>();
+            }
+            sink = static_cast<float>(total);
+        });
+
+        TestScene test;
+        for (auto count : EntityCounts)
+        {
+            //the scene is only populated if one of the benchmarks passes the filter
+            bool populated = false;
+            auto prepare = [&]()
+            {
+                if (!populated)
+                {
+                    populate(test, count);
+                    populated = true;
+                }
+            };
+
+            runner.run("component.get", count,
+                [&]()
+            {
+                float total = 0.f;
+                for (auto entity : test.entities)
+                {
+                    total += entity.getComponent<xy::Transform>().getPosition().x;
+                }
+                sink = total;
+            }, prepare);
+
+            runner.run("component.iterate.dense", count,
+                [&]()
+            {
+                test.scene->view<DenseData>().each([](xy::Entity, DenseData& d) { d.x += d.vx; d.y += d.vy; });
+            }, prepare);
+
+            runner.run("component.iterate.sparse", count,
+                [&]()
+            {
+                test.scene->view<SparseData>().each([](xy::Entity, SparseData& d) { d.x += d.vx; d.y += d.vy; });
+            }, prepare);
+
+            runner.run("component.iterate.chunked", count,
+                [&]()
+            {
+                test.scene->view<ChunkedData>().each([](xy::Entity, ChunkedData& d) { d.x += d.vx; d.y += d.vy; });
+            }, prepare);
+        }
+    }
+
+    void prefabBenchmarks(BenchmarkRunner& runner)
+    {
+        xy::Prefab prefab;
+        prefab.addComponent(xy::Transform()).setPosition(10.f, 10.f);
+        prefab.addComponent(DenseData());
+        prefab.addComponent(ChunkedData());
+
+        TestScene test;
+        for (auto count : EntityCounts)
+        {
+            runner.run("prefab.instantiate", count,
+                [&]()
+            {
+                test.scene->instantiate(prefab, count);
+                test.update();
+            },
+                [&]() { test.reset(); });
+        }
+    }
+
+    void snapshotBenchmarks(BenchmarkRunner& runner)
+    {
+        TestScene test;
+        xy::Snapshot snapshot;
+        for (auto count : EntityCounts)
+        {
+            bool populated = false;
+            auto prepare = [&]()
+            {
+                if (!populated)
+                {
+                    populate(test, count);
+                    test.scene->createSnapshot(snapshot);
+                    populated = true;
+                }
+            };
+
+            runner.run("snapshot.create", count,
+                [&]()
+            {
+                test.scene->createSnapshot(snapshot);
+            }, prepare);
+
+            runner.run("snapshot.restore", count,
+                [&]()
+            {
+                test.scene->restoreSnapshot(snapshot);
+            },
+                [&]()
+            {
+                prepare();
+
+                //restoring modified entities is the usual case when rolling back
+                for (auto i = 0u; i < test.entities.size(); i += 10)
+                {
+                    test.entities[i].getComponent<DenseData>().x += 1.f;
+                }
+            });
+        }
+    }
+
+    void transformBenchmarks(BenchmarkRunner& runner)
+    {
+        //parents with ten children each, all of which move every frame
+        TestScene test;
+        for (auto count : EntityCounts)
+        {
+            bool populated = false;
+            runner.run("transform.update", count,
+                [&]()
+            {
+                test.update();
+            },
+                [&]()
+            {
+                if (!populated)
+                {
+                    populate(test, count);
+                    for (auto i = 0u; i < test.entities.size(); ++i)
+                    {
+                        if (i % 10 != 0)
+                        {
+                            auto& parent = test.entities[i - (i % 10)].getComponent<xy::Transform>();
+                            parent.addChild(test.entities[i].getComponent<xy::Transform>());
+                        }
+                    }
+                    populated = true;
+                }
+
+                for (auto entity : test.entities)
+                {
+                    entity.getComponent<xy::Transform>().move(1.f, 0.f);
+                }
+            });
+        }
+    }
+
+    void messageBenchmarks(BenchmarkRunner& runner)
+    {
+        xy::MessageBus messageBus;
+        for (auto count : EntityCounts)
+        {
+            runner.run("messagebus.postpoll", count,
+                [&]()
+            {
+                for (auto i = 0u; i < count; ++i)
+                {
+                    auto* msg = messageBus.post<BenchMessage>(xy::Message::Count);
+                    msg->value = i;
+                }
+
+                sf::Uint32 total = 0;
+                while (!messageBus.empty())
+                {
+                    total += messageBus.poll().getData<BenchMessage>().value;
+                }
+                sink = static_cast<float>(total);
+            });
+
+            runner.run("messagebus.postthreaded", count,
+                [&]()
+            {
+                xy::JobSystem::parallelFor(count, [&messageBus](std::size_t start, std::size_t end)
+                {
+                    for (auto i = start; i < end; ++i)
+                    {
+                        BenchMessage msg;
+                        msg.value = static_cast<sf::Uint32>(i);
+                        messageBus.post(xy::Message::Count, msg);
+                    }
+                }, 256);
+
+                while (!messageBus.empty()) messageBus.poll();
+            });
+        }
+    }
+
+    void configBenchmarks(BenchmarkRunner& runner)
+    {
+        const std::string path("xyginext_bench.cfg");
+        for (auto count : { 100u, 1000u, 10000u })
+        {
+            bool saved = false;
+            runner.run("configfile.parse", count,
+                [&]()
+            {
+                xy::ConfigFile loaded;
+                loaded.loadFromFile(path);
+            },
+                [&]()
+            {
+                if (!saved)
+                {
+                    xy::ConfigFile file("bench");
+                    for (auto i = 0u; i < count; ++i)
+                    {
+                        auto* obj = file.addObject("object", std::to_string(i));
+                        obj->addProperty("name", "\"object " + std::to_string(i) + "\"");
+                        obj->addProperty("position", std::to_string(i) + "," + std::to_string(i * 2));
+                        obj->addProperty("rotation", std::to_string(i % 360));
+                        obj->addProperty("visible", "true");
+                        auto* child = obj->addObject("child");
+                        child->addProperty("colour", "255,128,0,255");
+                        child->addProperty("scale", "1.5,1.5");
+                    }
+                    file.save(path);
+                    saved = true;
+                }
+            });
+        }
+        std::remove(path.c_str());
+    }
+}
+
+void runCoreBenchmarks(BenchmarkRunner& runner)
+{
+    entityBenchmarks(runner);
+    componentBenchmarks(runner);
+    prefabBenchmarks(runner);
+    snapshotBenchmarks(runner);
+    transformBenchmarks(runner);
+    messageBenchmarks(runner);
+    configBenchmarks(runner);
+}
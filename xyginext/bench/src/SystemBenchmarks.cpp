@@ -0,0 +1,319 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//runs each of the built in systems over scenes of increasing size.
+//the AudioSystem, ParticleSystem and TextRenderer are not included
+//as they require an audio device, OpenGL context or font to run,
+//and drawing isn't measured as there is no window to draw to.
+
+#include "Benchmark.hpp"
+#include "TestScene.hpp"
+
+#include <xyginext/ecs/components/Transform.hpp>
+#include <xyginext/ecs/components/Callback.hpp>
+#include <xyginext/ecs/components/Camera.hpp>
+#include <xyginext/ecs/components/CommandTarget.hpp>
+#include <xyginext/ecs/components/NetInterpolation.hpp>
+#include <xyginext/ecs/components/QuadTreeItem.hpp>
+#include <xyginext/ecs/components/Drawable.hpp>
+#include <xyginext/ecs/components/Sprite.hpp>
+#include <xyginext/ecs/components/SpriteAnimation.hpp>
+#include <xyginext/ecs/components/UIHitBox.hpp>
+
+#include <xyginext/ecs/systems/CallbackSystem.hpp>
+#include <xyginext/ecs/systems/CameraSystem.hpp>
+#include <xyginext/ecs/systems/CommandSystem.hpp>
+#include <xyginext/ecs/systems/InterpolationSystem.hpp>
+#include <xyginext/ecs/systems/QuadTree.hpp>
+#include <xyginext/ecs/systems/RenderSystem.hpp>
+#include <xyginext/ecs/systems/SpriteSystem.hpp>
+#include <xyginext/ecs/systems/SpriteAnimator.hpp>
+#include <xyginext/ecs/systems/UISystem.hpp>
+
+#include <random>
+
+namespace
+{
+    const sf::FloatRect WorldArea(0.f, 0.f, 10000.f, 10000.f);
+
+    //positions are random but the same for every run
+    std::mt19937 rndEngine;
+
+    sf::Vector2f randomPosition()
+    {
+        std::uniform_real_distribution<float> dist(0.f, WorldArea.width);
+        return { dist(rndEngine), dist(rndEngine) };
+    }
+
+    /*!
+    \brief Times the update of a scene containing count entities,
+    created with createEntity in a scene set up by addSystems, after
+    optionally calling beforeFrame.
+    The scene is created the first time the benchmark is run.
+    */
+    void runSystemBenchmark(BenchmarkRunner& runner, const std::string& name,
+        const std::function<void(TestScene&)>& addSystems,
+        const std::function<void(xy::Entity, std::size_t)>& createEntity,
+        const std::function<void(TestScene&)>& beforeFrame = nullptr)
+    {
+        for (auto count : EntityCounts)
+        {
+            TestScene test;
+            bool populated = false;
+
+            runner.run("system." + name, count,
+                [&]()
+            {
+                test.update();
+            },
+                [&]()
+            {
+                if (!populated)
+                {
+                    rndEngine.seed(1234);
+                    test.reset();
+                    addSystems(test);
+                    for (auto i = 0u; i < count; ++i)
+                    {
+                        auto entity = test.scene->createEntity();
+                        createEntity(entity, i);
+                        test.entities.push_back(entity);
+                    }
+                    test.update();
+                    populated = true;
+                }
+
+                if (beforeFrame)
+                {
+                    beforeFrame(test);
+                }
+            });
+        }
+    }
+
+    void quadTreeBenchmarks(BenchmarkRunner& runner)
+    {
+        auto createEntity = [](xy::Entity entity, std::size_t)
+        {
+            entity.addComponent<xy::Transform>().setPosition(randomPosition());
+            entity.addComponent<xy::QuadTreeItem>().setArea({ 0.f, 0.f, 16.f, 16.f });
+        };
+
+        for (auto count : EntityCounts)
+        {
+            TestScene test;
+            auto fillTree = [&]()
+            {
+                rndEngine.seed(1234);
+                test.reset();
+                test.scene->addSystem<xy::QuadTree>(test.messageBus, WorldArea);
+                for (auto i = 0u; i < count; ++i)
+                {
+                    createEntity(test.scene->createEntity(), i);
+                }
+            };
+
+            //entities are inserted when the scene is next updated
+            runner.run("quadtree.insert", count,
+                [&]()
+            {
+                test.update();
+            }, fillTree);
+
+            //1000 queries of an area roughly the size of the screen
+            bool filled = false;
+            runner.run("quadtree.query", count,
+                [&]()
+            {
+                std::size_t total = 0;
+                const auto& tree = test.scene->getSystem<xy::QuadTree>();
+                for (auto i = 0; i < 1000; ++i)
+                {
+                    total += tree.queryArea({ randomPosition(), { 960.f, 540.f } }).size();
+                }
+                volatile std::size_t sink = total;
+                (void)sink;
+            },
+                [&]()
+            {
+                if (!filled)
+                {
+                    fillTree();
+                    test.update();
+                    filled = true;
+                }
+                rndEngine.seed(5678);
+            });
+        }
+
+        runSystemBenchmark(runner, "QuadTree",
+            [](TestScene& test) { test.scene->addSystem<xy::QuadTree>(test.messageBus, WorldArea); },
+            createEntity,
+            [](TestScene& test)
+        {
+            for (auto entity : test.entities)
+            {
+                entity.getComponent<xy::Transform>().move(1.f, 1.f);
+            }
+        });
+    }
+}
+
+void runSystemBenchmarks(BenchmarkRunner& runner)
+{
+    runSystemBenchmark(runner, "CallbackSystem",
+        [](TestScene& test) { test.scene->addSystem<xy::CallbackSystem>(test.messageBus); },
+        [](xy::Entity entity, std::size_t)
+    {
+        entity.addComponent<xy::Transform>();
+        auto& callback = entity.addComponent<xy::Callback>();
+        callback.active = true;
+        callback.function = [](xy::Entity e, float dt)
+        {
+            e.getComponent<xy::Transform>().move(dt, dt);
+        };
+    });
+
+    runSystemBenchmark(runner, "CameraSystem",
+        [](TestScene& test) { test.scene->addSystem<xy::CameraSystem>(test.messageBus); },
+        [](xy::Entity entity, std::size_t)
+    {
+        entity.addComponent<xy::Transform>().setPosition(randomPosition());
+        entity.addComponent<xy::Camera>();
+    });
+
+    runSystemBenchmark(runner, "CommandSystem",
+        [](TestScene& test) { test.scene->addSystem<xy::CommandSystem>(test.messageBus); },
+        [](xy::Entity entity, std::size_t i)
+    {
+        entity.addComponent<xy::Transform>();
+        entity.addComponent<xy::CommandTarget>().ID = (i % 2) ? 1 : 2;
+    },
+        [](TestScene& test)
+    {
+        //one command to half the entities, and one to all of them
+        xy::Command cmd;
+        cmd.targetFlags = 1;
+        cmd.action = [](xy::Entity e, float dt) { e.getComponent<xy::Transform>().move(dt, 0.f); };
+        test.scene->getSystem<xy::CommandSystem>().sendCommand(cmd);
+        cmd.targetFlags = 1 | 2;
+        test.scene->getSystem<xy::CommandSystem>().sendCommand(cmd);
+    });
+
+    runSystemBenchmark(runner, "InterpolationSystem",
+        [](TestScene& test) { test.scene->addSystem<xy::InterpolationSystem>(test.messageBus); },
+        [](xy::Entity entity, std::size_t)
+    {
+        entity.addComponent<xy::Transform>().setPosition(randomPosition());
+        entity.addComponent<xy::NetInterpolate>();
+    },
+        [](TestScene& test)
+    {
+        static sf::Int32 timestamp = 0;
+        timestamp += 16;
+        for (auto entity : test.entities)
+        {
+            entity.getComponent<xy::NetInterpolate>().setTarget(randomPosition(), timestamp);
+        }
+    });
+
+    //sorting is forced each frame by changing the depth of some drawables
+    runSystemBenchmark(runner, "RenderSystem",
+        [](TestScene& test) { test.scene->addSystem<xy::RenderSystem>(test.messageBus); },
+        [](xy::Entity entity, std::size_t i)
+    {
+        entity.addComponent<xy::Transform>().setPosition(randomPosition());
+        auto& drawable = entity.addComponent<xy::Drawable>();
+        drawable.setDepth(static_cast<sf::Int32>(i % 16));
+        drawable.getVertices().resize(4);
+        drawable.updateLocalBounds();
+    },
+        [](TestScene& test)
+    {
+        for (auto i = 0u; i < test.entities.size(); i += 100)
+        {
+            auto& drawable = test.entities[i].getComponent<xy::Drawable>();
+            drawable.setDepth((drawable.getDepth() + 1) % 16);
+        }
+    });
+
+    //every sprite is modified each frame
+    runSystemBenchmark(runner, "SpriteSystem",
+        [](TestScene& test) { test.scene->addSystem<xy::SpriteSystem>(test.messageBus); },
+        [](xy::Entity entity, std::size_t)
+    {
+        entity.addComponent<xy::Transform>().setPosition(randomPosition());
+        entity.addComponent<xy::Sprite>().setTextureRect({ 0.f, 0.f, 32.f, 32.f });
+        entity.addComponent<xy::Drawable>();
+    },
+        [](TestScene& test)
+    {
+        static sf::Uint8 alpha = 0;
+        alpha++;
+        for (auto entity : test.entities)
+        {
+            entity.getComponent<xy::Sprite>().setColour({ 255, 255, 255, alpha });
+            entity.markChanged<xy::Sprite>();
+        }
+    });
+
+    runSystemBenchmark(runner, "SpriteAnimator",
+        [](TestScene& test)
+    {
+        test.scene->addSystem<xy::SpriteAnimator>(test.messageBus);
+        test.scene->addSystem<xy::SpriteSystem>(test.messageBus);
+    },
+        [](xy::Entity entity, std::size_t)
+    {
+        entity.addComponent<xy::Transform>();
+        entity.addComponent<xy::Drawable>();
+
+        auto& sprite = entity.addComponent<xy::Sprite>();
+        auto& anim = sprite.getAnimations()[0];
+        for (auto i = 0u; i < 8u; ++i)
+        {
+            anim.frames[i] = { i * 32.f, 0.f, 32.f, 32.f };
+        }
+        anim.frameCount = 8;
+        anim.framerate = 60.f;
+        anim.looped = true;
+
+        entity.addComponent<xy::SpriteAnimation>().play(0);
+    });
+
+    runSystemBenchmark(runner, "UISystem",
+        [](TestScene& test) { test.scene->addSystem<xy::UISystem>(test.messageBus); },
+        [](xy::Entity entity, std::size_t)
+    {
+        entity.addComponent<xy::Transform>().setPosition(randomPosition());
+        auto& hitbox = entity.addComponent<xy::UIHitBox>();
+        hitbox.area = { 0.f, 0.f, 64.f, 32.f };
+        hitbox.active = true;
+    });
+
+    quadTreeBenchmarks(runner);
+}
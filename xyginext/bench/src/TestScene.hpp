@@ -0,0 +1,59 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_BENCH_TEST_SCENE_HPP_
+#define XY_BENCH_TEST_SCENE_HPP_
+
+#include <xyginext/core/MessageBus.hpp>
+#include <xyginext/ecs/Scene.hpp>
+
+#include <memory>
+#include <vector>
+
+/*!
+\brief A headless scene with its own message bus, used by
+benchmarks which need to recreate the scene between runs
+*/
+struct TestScene final
+{
+    xy::MessageBus messageBus;
+    std::unique_ptr<xy::Scene> scene;
+    std::vector<xy::Entity> entities;
+
+    /*!
+    \brief Replaces the scene with a new, empty scene
+    */
+    void reset();
+
+    /*!
+    \brief Updates the scene with a fixed frame time and
+    discards any messages posted during the update
+    */
+    void update();
+};
+
+#endif //XY_BENCH_TEST_SCENE_HPP_
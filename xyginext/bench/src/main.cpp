@@ -0,0 +1,129 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+//runs the xyginext benchmarks headlessly and writes the results as JSON.
+//usage: xyginext_bench [--filter <text>] [--iterations <count>] [--workers <count>] [--output <file>]
+
+#include "Benchmark.hpp"
+
+#include <xyginext/core/JobSystem.hpp>
+
+#include <iostream>
+#include <fstream>
+#include <string>
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: xyginext_bench [options]\n"
+            << "  --filter <text>      only run benchmarks whose name contains <text>\n"
+            << "  --iterations <count> number of timed runs of each benchmark (default 10)\n"
+            << "  --workers <count>    number of job system worker threads (default auto)\n"
+            << "  --output <file>      write results to <file> instead of stdout\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    BenchmarkRunner runner;
+    std::string outputPath;
+
+    for (auto i = 1; i < argc; ++i)
+    {
+        const std::string arg(argv[i]);
+        if (arg == "--help" || arg == "-h")
+        {
+            printUsage();
+            return 0;
+        }
+
+        if (i + 1 == argc)
+        {
+            printUsage();
+            return 1;
+        }
+
+        const std::string value(argv[++i]);
+        try
+        {
+            if (arg == "--filter")
+            {
+                runner.setFilter(value);
+            }
+            else if (arg == "--iterations")
+            {
+                runner.setIterations(std::stoul(value));
+            }
+            else if (arg == "--workers")
+            {
+                xy::JobSystem::setWorkerCount(std::stoi(value));
+            }
+            else if (arg == "--output")
+            {
+                outputPath = value;
+            }
+            else
+            {
+                printUsage();
+                return 1;
+            }
+        }
+        catch (...)
+        {
+            std::cerr << "Invalid value for " << arg << ": " << value << "\n";
+            return 1;
+        }
+    }
+
+    //anything xygine logs to stdout would otherwise end up in the results
+    auto* stdoutBuffer = std::cout.rdbuf(std::cerr.rdbuf());
+    xy::JobSystem::getActiveWorkerCount(); //starts the workers
+
+    runCoreBenchmarks(runner);
+    runSystemBenchmarks(runner);
+
+    std::cout.rdbuf(stdoutBuffer);
+
+    if (outputPath.empty())
+    {
+        runner.writeJson(std::cout);
+    }
+    else
+    {
+        std::ofstream file(outputPath);
+        if (!file.is_open() || !file.good())
+        {
+            std::cerr << "Failed opening " << outputPath << "\n";
+            return 1;
+        }
+        runner.writeJson(file);
+    }
+
+    xy::JobSystem::shutdown();
+    return 0;
+}
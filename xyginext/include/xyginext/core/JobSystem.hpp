@@ -0,0 +1,183 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_JOB_SYSTEM_HPP_
+#define XY_JOB_SYSTEM_HPP_
+
+#include <xyginext/Config.hpp>
+#include <SFML/Config.hpp>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <functional>
+
+namespace xy
+{
+    /*!
+    \brief Work stealing thread pool shared by all scenes.
+    The JobSystem owns a set of worker threads, each with its
+    own queue of jobs. Jobs submitted from a worker are pushed
+    to that worker's queue, and idle workers steal from the
+    queues of busy ones. Any thread waiting on a set of jobs
+    helps execute outstanding work rather than blocking, so
+    parallel operations may be safely nested.
+    By default the number of workers is one less than the
+    hardware concurrency (the calling thread makes up the
+    difference), which can be overridden with the 'workers'
+    property of the 'jobs' object in settings.cfg. With zero
+    workers all jobs are executed on the calling thread.
+    The worker threads are started on first use.
+    */
+    class XY_EXPORT_API JobSystem final
+    {
+    public:
+        /*!
+        \brief Sets the number of worker threads to use.
+        Negative values select the default based on the
+        hardware concurrency. If the workers are already
+        running they are restarted, so this must not be
+        called while any jobs are in flight.
+        */
+        static void setWorkerCount(sf::Int32 count);
+
+        /*!
+        \brief Returns the worker count as set with setWorkerCount().
+        This may be negative if the default is in use.
+        */
+        static sf::Int32 getWorkerCount();
+
+        /*!
+        \brief Returns the number of worker threads actually running,
+        starting them if necessary
+        */
+        static std::size_t getActiveWorkerCount();
+
+        /*!
+        \brief Splits the range [0, count) into batches and
+        executes them in parallel, returning once all have completed.
+        The split depends only on the count, minBatchSize and number
+        of workers, and each batch covers a contiguous range, so
+        provided func only writes to data belonging to the indices
+        it is given the result is deterministic.
+        \param count Number of items to process
+        \param func Function called with the start and end (exclusive)
+        of each batch
+        \param minBatchSize Smallest number of items worth executing
+        as a single job. Ranges smaller than this are executed directly
+        on the calling thread.
+        */
+        static void parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& func, std::size_t minBatchSize = 64);
+
+        /*!
+        \brief Sets an opaque context pointer for the calling thread.
+        Jobs capture the context of the thread which submits them and
+        it is restored for the duration of the job on whichever thread
+        executes it. The SystemManager uses this to identify the system
+        being processed in debug builds.
+        */
+        static void setContext(const void*);
+
+        /*!
+        \brief Returns the context pointer of the calling thread
+        \see setContext()
+        */
+        static const void* getContext();
+
+        /*!
+        \brief Stops and joins all worker threads.
+        This is called automatically by xy::App on exit. The workers
+        are restarted should any further jobs be submitted.
+        */
+        static void shutdown();
+    };
+
+    /*!
+    \brief A set of tasks with dependencies between them,
+    executed on the JobSystem.
+    Tasks with no outstanding dependencies are submitted
+    immediately, and each task is submitted as soon as
+    all of the tasks it depends on have completed.
+    The graph must be acyclic. A graph can be executed
+    any number of times once it has been built.
+    */
+    class XY_EXPORT_API TaskGraph final
+    {
+    public:
+        using TaskID = std::size_t;
+
+        TaskGraph() = default;
+        ~TaskGraph() = default;
+        TaskGraph(const TaskGraph&) = delete;
+        TaskGraph& operator = (const TaskGraph&) = delete;
+        TaskGraph(TaskGraph&&) = default;
+        TaskGraph& operator = (TaskGraph&&) = default;
+
+        /*!
+        \brief Adds a task to the graph
+        \returns ID of the task, used when declaring dependencies
+        */
+        TaskID addTask(const std::function<void()>& task);
+
+        /*!
+        \brief Declares that the task with ID 'after' may not
+        start until the task with ID 'before' has completed.
+        */
+        void addDependency(TaskID before, TaskID after);
+
+        /*!
+        \brief Executes all the tasks in the graph, returning
+        once they have all completed. The calling thread helps
+        execute the tasks while waiting.
+        */
+        void execute();
+
+        /*!
+        \brief Removes all tasks from the graph
+        */
+        void clear();
+
+        /*!
+        \brief Returns the number of tasks in the graph
+        */
+        std::size_t size() const { return m_tasks.size(); }
+
+    private:
+        struct Task final
+        {
+            std::function<void()> func;
+            std::vector<TaskID> successors;
+            std::size_t dependencyCount = 0;
+            std::atomic<std::size_t> remaining;
+        };
+        std::vector<std::unique_ptr<Task>> m_tasks;
+
+        void submit(TaskID, std::atomic<std::size_t>&);
+    };
+}
+
+#endif //XY_JOB_SYSTEM_HPP_
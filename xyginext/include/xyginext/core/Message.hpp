@@ -47,6 +47,8 @@ namespace xy
     class XY_EXPORT_API Message final
     {
         friend class MessageBus;
+        friend class TraceRecorder;
+        friend class TracePlayer;
     public:
         using ID = sf::Int32;
         enum Type
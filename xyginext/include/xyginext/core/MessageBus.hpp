@@ -35,6 +35,11 @@ source distribution.
 #include <xyginext/core/Message.hpp>
 
 #include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <cstddef>
 #include <type_traits>
 
 namespace xy
@@ -54,10 +59,35 @@ namespace xy
         GhostEvent,
         BadgerEvent //etc...
     };
+
+    Messages are stored in fixed size pages. More pages are allocated
+    when a frame posts more messages than will fit in those already
+    allocated, and pages are recycled once their messages have been read.
+
+    Messages may be posted from any thread. Messages posted from threads
+    other than the one which reads them, such as job system workers or a
+    network thread, are staged separately for each thread and added to
+    the bus when the message buffers are next swapped, after any messages
+    posted by the reading thread. Messages from any one thread are always
+    read in the order in which they were posted.
     */
     class XY_EXPORT_API MessageBus final
     {
     public:
+        /*!
+        \brief Message counts and memory usage, used for profiling.
+        A frame is the period between two swaps of the message buffers,
+        when all the messages from the previous frame have been read.
+        */
+        struct Stats final
+        {
+            std::size_t messageCount = 0; //!< messages posted in the last frame
+            std::size_t byteCount = 0; //!< bytes used by messages posted in the last frame
+            std::size_t peakMessageCount = 0; //!< most messages posted in a single frame
+            std::size_t peakByteCount = 0; //!< most bytes used by a single frame
+            std::size_t pageCount = 0; //!< number of pages currently allocated
+        };
+
         MessageBus();
         ~MessageBus() = default;
         MessageBus(const MessageBus&) = delete;
@@ -79,42 +109,80 @@ namespace xy
         Custom message types should have a unique 32 bit integer ID which can be used
         to identify the message type when reading messages. Message data has a maximum
         size of 128 bytes.
+        When posting from a thread which runs independently of the thread
+        reading messages, such as a network thread, use the overload of post()
+        which copies the message data instead, as the message may otherwise
+        be read before it has been filled in.
         \param id Unique ID for this message type
         \returns Pointer to an empty message of given type.
         */
         template <typename T>
         T* post(Message::ID id)
         {
-            if (!m_enabled) return static_cast<T*>((void*)m_pendingBuffer.data());
+            static_assert(sizeof(T) <= MaxDataSize, "message size exceeds 128 bytes"); //limit custom data to 128 bytes
+            static_assert(alignof(T) <= alignof(std::max_align_t), "message data is over aligned");
 
-            auto dataSize = sizeof(T);
-            static auto msgSize = sizeof(Message);
-            XY_ASSERT(dataSize < 128, "message size exceeds 128 bytes"); //limit custom data to 128 bytes
-            XY_ASSERT(m_pendingBuffer.size() - (m_inPointer - m_pendingBuffer.data()) > (dataSize + msgSize), "buffer overflow " + std::to_string(m_pendingCount)); //make sure we have enough room in the buffer
-            XY_WARNING(m_pendingBuffer.size() - (m_inPointer - m_pendingBuffer.data()) < 128, "Messagebus buffer is heavily contended!");
+            if (!m_enabled) return static_cast<T*>((void*)m_disabledBuffer.data());
 
-            Message* msg = new (m_inPointer)Message();
-            m_inPointer += msgSize;
-            msg->id = id;
-            msg->m_dataSize = dataSize;
-            msg->m_data = new (m_inPointer)T();
-            m_inPointer += dataSize;
+            if (std::this_thread::get_id() == m_readerThread.load(std::memory_order_relaxed))
+            {
+                m_pendingCount++;
+                return create<T>(allocate(HeaderSize + alignSize(sizeof(T))), id);
+            }
 
-            m_pendingCount++;
-            return static_cast<T*>(msg->m_data);
+            auto& staging = getStaging();
+            std::lock_guard<std::mutex> lock(staging.mutex);
+            return create<T>(allocate(staging, HeaderSize + alignSize(sizeof(T))), id);
         }
 
         /*!
-        \brief Returns true if there are no messages left on the message bus
+        \brief Places a message on the message stack with a copy of the given data.
+        The message is complete before it can be read, so this can be safely
+        used from any thread.
+        \param id Unique ID for this message type
+        \param data Message data to copy
+        */
+        template <typename T>
+        void post(Message::ID id, const T& data)
+        {
+            static_assert(sizeof(T) <= MaxDataSize, "message size exceeds 128 bytes");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "message data is over aligned");
+
+            if (!m_enabled) return;
+
+            if (std::this_thread::get_id() == m_readerThread.load(std::memory_order_relaxed))
+            {
+                m_pendingCount++;
+                *create<T>(allocate(HeaderSize + alignSize(sizeof(T))), id) = data;
+                return;
+            }
+
+            auto& staging = getStaging();
+            std::lock_guard<std::mutex> lock(staging.mutex);
+            *create<T>(allocate(staging, HeaderSize + alignSize(sizeof(T))), id) = data;
+        }
+
+        /*!
+        \brief Returns true if there are no messages left on the message bus.
+        When the last message has been read the message buffers are swapped,
+        so that messages posted since the last swap can be read. The thread
+        which calls this is considered to be the thread reading messages.
         */
         bool empty();
         /*!
-        \brief Returns the number of messages currently sitting on the message bus
+        \brief Returns the number of messages currently sitting on the message bus.
+        This doesn't include messages posted from other threads which have not
+        yet been added to the bus.
 
         Useful for stat logging and debugging.
         */
         std::size_t pendingMessageCount() const;
 
+        /*!
+        \brief Returns the message counts and memory usage of the bus
+        */
+        const Stats& getStats() const { return m_stats; }
+
         /*!
         \brief Disables the message bus.
         Used internally by xygine
@@ -122,15 +190,82 @@ namespace xy
         void disable() { m_enabled = false; }
 
     private:
+        static constexpr std::size_t MaxDataSize = 128;
+        static constexpr std::size_t PageSize = 16384;
 
-        std::vector<char> m_currentBuffer;
-        std::vector<char> m_pendingBuffer;
-        char* m_inPointer;
-        char* m_outPointer;
+        static constexpr std::size_t alignSize(std::size_t size)
+        {
+            return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        }
+        static constexpr std::size_t HeaderSize = (sizeof(Message) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+
+        struct Page final
+        {
+            std::unique_ptr<char[]> data;
+            std::size_t used = 0;
+        };
+
+        //pages being written to by post(), and those being read by poll()
+        std::vector<std::unique_ptr<Page>> m_pendingPages;
+        std::vector<std::unique_ptr<Page>> m_currentPages;
+
+        //shared by all threads which post messages
+        std::mutex m_freeMutex;
+        std::vector<std::unique_ptr<Page>> m_freePages;
+
+        //messages posted from other threads, one for each thread
+        struct Staging final
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Page>> pages;
+            std::size_t messageCount = 0;
+            std::size_t byteCount = 0;
+        };
+        std::mutex m_stagingMutex;
+        std::vector<std::unique_ptr<Staging>> m_staging;
+        const sf::Uint64 m_uid; //identifies this bus to each thread's cache of staging buffers
+        std::atomic<std::thread::id> m_readerThread;
+
+        Page* m_inPage;
+        std::size_t m_outPage;
+        std::size_t m_outOffset;
         std::size_t m_currentCount;
         std::size_t m_pendingCount;
+        std::size_t m_pendingBytes;
+
+        std::vector<char> m_disabledBuffer;
+        std::atomic<bool> m_enabled;
+
+        Stats m_stats;
 
-        bool m_enabled;
+        char* allocate(std::size_t size)
+        {
+            if (!m_inPage || m_inPage->used + size > PageSize)
+            {
+                nextPage();
+            }
+
+            auto* ptr = m_inPage->data.get() + m_inPage->used;
+            m_inPage->used += size;
+            m_pendingBytes += size;
+            return ptr;
+        }
+
+        char* allocate(Staging&, std::size_t);
+        Staging& getStaging();
+        std::unique_ptr<Page> getFreePage();
+        void nextPage();
+
+        template <typename T>
+        T* create(char* ptr, Message::ID id)
+        {
+            //data is placed directly after the message, so both stay aligned
+            Message* msg = new (ptr)Message();
+            msg->id = id;
+            msg->m_dataSize = sizeof(T);
+            msg->m_data = new (ptr + HeaderSize)T();
+            return static_cast<T*>(msg->m_data);
+        }
     };
 }
 #endif //XY_MESSAGE_BUS_HPP_
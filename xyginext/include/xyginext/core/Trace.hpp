@@ -0,0 +1,197 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_TRACE_HPP_
+#define XY_TRACE_HPP_
+
+#include <xyginext/Config.hpp>
+#include <SFML/Config.hpp>
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace sf
+{
+    class Event;
+}
+
+namespace xy
+{
+    class Message;
+
+    /*!
+    \brief Records a trace of the events and messages handled by xy::App.
+    While recording, every fixed update of the App writes the frame number
+    and frame time to the trace, followed by each sf::Event passed to
+    App::handleEvent() (and from there to any Scene::forwardEvent()) and
+    each message read from App::getMessageBus(). A trace can be replayed
+    with TracePlayer to reproduce a session, for example to benchmark
+    exactly the same workload before and after a change.
+    Records are buffered on the main thread and written to disk by a
+    separate thread, so recording doesn't wait on file IO. Message data
+    is copied as raw bytes, so messages containing pointers will not be
+    meaningful when replayed. Traces use the native byte order and are
+    not intended to be shared between platforms.
+    Recording can also be started from the console with 'trace_start <file>'
+    and stopped with 'trace_stop'.
+    */
+    class XY_EXPORT_API TraceRecorder final
+    {
+    public:
+        /*!
+        \brief Starts recording a trace to the given file, stopping
+        any trace currently being recorded.
+        \returns false if the file could not be opened
+        */
+        static bool start(const std::string& path);
+
+        /*!
+        \brief Stops recording and closes the trace file once all
+        outstanding records have been written.
+        This is called automatically by xy::App on exit.
+        */
+        static void stop();
+
+        /*!
+        \brief Returns true if a trace is currently being recorded
+        */
+        static bool isRecording();
+
+        /*!
+        \brief Marks the start of a frame with the given frame time.
+        Used internally by xygine
+        */
+        static void beginFrame(float dt);
+
+        /*!
+        \brief Records an event for the current frame.
+        Used internally by xygine
+        */
+        static void recordEvent(const sf::Event&);
+
+        /*!
+        \brief Records a message for the current frame.
+        Used internally by xygine
+        */
+        static void recordMessage(const Message&);
+    };
+
+    /*!
+    \brief Replays a trace recorded with TraceRecorder.
+    The player doesn't require an App or a window, so a trace can be
+    replayed headlessly by passing the recorded events and messages
+    to a set of scenes and updating them with the recorded frame time.
+    EG
+
+    xy::TracePlayer player;
+    player.setEventHandler([&scene](const sf::Event& evt) { scene.forwardEvent(evt); });
+    player.setMessageHandler([&scene](const xy::Message& msg) { scene.forwardMessage(msg); });
+
+    while (player.nextFrame())
+    {
+        scene.update(player.getFrameTime());
+        while (!messageBus.empty()) messageBus.poll();
+    }
+
+    Messages posted by the scenes during replay are already part of the
+    trace, so should be read and discarded as above rather than forwarded.
+    Note that the trace contains every message which was posted while it
+    was recorded, including those posted by systems. Replaying them into
+    a live Scene, whose systems post the same messages again as they
+    update, delivers those messages twice. The message handler should
+    therefore only forward the messages which originate outside of the
+    scenes being replayed, such as those posted by the application.
+    */
+    class XY_EXPORT_API TracePlayer final
+    {
+    public:
+        TracePlayer();
+
+        /*!
+        \brief Loads a trace from the given file.
+        The entire trace is read into memory so that replay
+        doesn't include any file IO.
+        \returns false if the file could not be read or is not a valid trace
+        */
+        bool loadFromFile(const std::string& path);
+
+        /*!
+        \brief Sets the function called with each recorded event
+        */
+        void setEventHandler(const std::function<void(const sf::Event&)>& handler) { m_eventHandler = handler; }
+
+        /*!
+        \brief Sets the function called with each recorded message
+        */
+        void setMessageHandler(const std::function<void(const Message&)>& handler) { m_messageHandler = handler; }
+
+        /*!
+        \brief Reads the next frame of the trace, passing its events and
+        messages to the event and message handlers in the order in which
+        they were recorded.
+        \returns false if there are no frames left to replay
+        */
+        bool nextFrame();
+
+        /*!
+        \brief Returns the number of the frame last read with nextFrame()
+        */
+        sf::Uint32 getFrame() const { return m_frame; }
+
+        /*!
+        \brief Returns the frame time of the frame last read with nextFrame()
+        */
+        float getFrameTime() const { return m_frameTime; }
+
+        /*!
+        \brief Returns the number of frames in the loaded trace
+        */
+        std::size_t getFrameCount() const { return m_frameCount; }
+
+        /*!
+        \brief Rewinds the trace to the first frame
+        */
+        void rewind();
+
+    private:
+        std::vector<char> m_data;
+        std::size_t m_readOffset;
+        std::size_t m_frameCount;
+
+        sf::Uint32 m_frame;
+        float m_frameTime;
+
+        std::function<void(const sf::Event&)> m_eventHandler;
+        std::function<void(const Message&)> m_messageHandler;
+
+        template <typename T>
+        bool read(T&);
+    };
+}
+
+#endif //XY_TRACE_HPP_
@@ -0,0 +1,92 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_MESSAGE_SUBSCRIBERS_HPP_
+#define XY_MESSAGE_SUBSCRIBERS_HPP_
+
+#include <xyginext/core/Message.hpp>
+
+#include <vector>
+
+namespace xy
+{
+    namespace Detail
+    {
+        /*!
+        \brief Lists of message subscribers, such as systems or directors,
+        indexed by message ID. Subscribers which receive every message are
+        included in every list, so each list is in the order in which its
+        subscribers were added.
+        */
+        template <typename T>
+        class MessageSubscribers final
+        {
+        public:
+            void clear()
+            {
+                m_lists.clear();
+                m_all.clear();
+            }
+
+            void add(T* subscriber, const std::vector<Message::ID>& ids, bool all)
+            {
+                if (all)
+                {
+                    m_all.push_back(subscriber);
+                    for (auto& list : m_lists)
+                    {
+                        list.push_back(subscriber);
+                    }
+                    return;
+                }
+
+                for (auto id : ids)
+                {
+                    const auto index = static_cast<std::size_t>(id);
+                    if (index >= m_lists.size())
+                    {
+                        //new lists start with the subscribers to everything
+                        m_lists.resize(index + 1, m_all);
+                    }
+                    m_lists[index].push_back(subscriber);
+                }
+            }
+
+            const std::vector<T*>& get(Message::ID id) const
+            {
+                const auto index = static_cast<std::size_t>(id);
+                return (id >= 0 && index < m_lists.size()) ? m_lists[index] : m_all;
+            }
+
+        private:
+            std::vector<std::vector<T*>> m_lists;
+            std::vector<T*> m_all;
+        };
+    }
+}
+
+#endif //XY_MESSAGE_SUBSCRIBERS_HPP_
@@ -0,0 +1,216 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_ARCHETYPE_STORAGE_HPP_
+#define XY_ARCHETYPE_STORAGE_HPP_
+
+#include <xyginext/Config.hpp>
+#include <xyginext/core/Assert.hpp>
+#include <xyginext/ecs/Component.hpp>
+#include <xyginext/ecs/ComponentPool.hpp>
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <unordered_map>
+
+namespace xy
+{
+    class Entity;
+
+    namespace Detail
+    {
+        /*!
+        \brief A table of every entity which has the same component mask.
+        Each row of the table is one entity, and each column stores the
+        components of one grouped type for every row, so that iterating
+        a table streams through each column linearly.
+        \see UseChunkedStorage
+        */
+        class XY_EXPORT_API ArchetypeTable final
+        {
+        public:
+            static constexpr std::uint8_t NoColumn = 0xff;
+            static constexpr std::uint32_t NoEntity = 0xffffffff; //< marks rows which have been removed
+
+            explicit ArchetypeTable(const ComponentMask&);
+
+            /*!
+            \brief Returns the component mask shared by every entity in the table
+            */
+            const ComponentMask& getMask() const { return m_mask; }
+
+            /*!
+            \brief Returns the number of rows in the table
+            */
+            std::size_t size() const { return m_entities.size(); }
+
+            /*!
+            \brief Returns the index of the entity in each row
+            */
+            const std::vector<std::uint32_t>& getEntities() const { return m_entities; }
+
+            /*!
+            \brief Returns the column which stores components of type T.
+            T must use grouped storage and be part of the table's mask.
+            */
+            template <class T>
+            ArchetypeColumnImpl<T>& getColumn() const
+            {
+                const auto id = Component::getID<T>();
+                XY_ASSERT(m_columnIndices[id] != NoColumn, "Table has no column for this component");
+                return static_cast<ArchetypeColumnImpl<T>&>(*m_columns[m_columnIndices[id]]);
+            }
+
+        private:
+            ComponentMask m_mask;
+            std::vector<std::uint32_t> m_entities;
+            std::vector<std::unique_ptr<ArchetypeColumn>> m_columns;
+            std::vector<Component::ID> m_columnIDs; //< component ID of each column
+            std::array<std::uint8_t, MaxComponents> m_columnIndices; //< indexed by component ID
+            std::vector<std::uint32_t> m_removedRows; //< rows waiting to be filled by compact()
+
+            friend class ArchetypeStorage;
+        };
+
+        /*!
+        \brief Owns the ArchetypeTables for component types which use
+        grouped storage, and tracks which table and row each entity occupies.
+        Entities are only moved between tables when the EntityManager
+        settles their component masks, so references to grouped components
+        remain valid until the Scene next updates.
+        */
+        class XY_EXPORT_API ArchetypeStorage final
+        {
+        public:
+            ArchetypeStorage();
+            ~ArchetypeStorage();
+            ArchetypeStorage(const ArchetypeStorage&) = delete;
+            ArchetypeStorage& operator = (const ArchetypeStorage&) = delete;
+
+            /*!
+            \brief Adds the pool of a component type which uses grouped storage
+            */
+            void addPool(Component::ID, StagedPool&);
+
+            /*!
+            \brief Makes room to track the tables of the given number of entities.
+            Called as entities are created so that update() rarely needs to resize.
+            */
+            void resize(std::size_t entityCount);
+
+            /*!
+            \brief Moves the entity's grouped components to the table matching
+            the given component mask, creating the table if needed. Components
+            staged in their pool are moved in, along with any in the table
+            the entity currently occupies. Components which aren't part of the
+            new mask are left behind and released. An empty mask removes the
+            entity from its table. The row it leaves is filled when compact()
+            is next called.
+            */
+            void update(std::size_t entity, const ComponentMask&);
+
+            /*!
+            \brief Fills the rows left by entities which have been removed from
+            their tables since this was last called, so that tables are packed
+            again. Removed rows which end up past the end of their table are
+            simply dropped, so removing many entities at once moves fewer rows.
+            This must be called before the tables are next read.
+            */
+            void compact();
+
+            /*!
+            \brief Returns true if any component type in the given mask has
+            components staged in its pool, which are not yet in a table
+            */
+            bool hasStaged(const ComponentMask&) const;
+
+            /*!
+            \brief Starts placing new entities, which have no components yet,
+            in the table for the given mask. Until endPlacement() is called
+            grouped components are constructed directly in the table's
+            columns rather than being staged, so every grouped component
+            in the mask must be added to each of the entities, in the same order.
+            */
+            void beginPlacement(const ComponentMask&);
+
+            /*!
+            \brief Adds the rows of the placed entities to the table, after
+            which components are staged as usual
+            */
+            void endPlacement(const std::vector<Entity>&);
+
+            /*!
+            \brief Returns a mask of every component type which uses grouped storage
+            */
+            const ComponentMask& getGroupedMask() const { return m_groupedMask; }
+
+            /*!
+            \brief Appends to dst each non-empty table whose mask contains
+            every component in the given mask
+            \returns The total number of rows in the tables which were added
+            */
+            std::size_t getTables(const ComponentMask&, std::vector<const ArchetypeTable*>& dst) const;
+
+        private:
+            struct Location final
+            {
+                ArchetypeTable* table = nullptr;
+                std::uint32_t row = 0;
+            };
+
+            std::vector<std::unique_ptr<ArchetypeTable>> m_tables;
+            std::unordered_map<ComponentMask, std::size_t> m_tableIndices;
+            std::vector<Location> m_locations; //< indexed by entity
+            std::array<StagedPool*, MaxComponents> m_pools; //< indexed by component ID
+            ComponentMask m_groupedMask;
+            ArchetypeTable* m_lastTable;
+            std::vector<ArchetypeTable*> m_uncompactedTables;
+
+            ComponentMask m_placementMask;
+            ArchetypeTable* m_placement;
+
+            ArchetypeTable& getTable(const ComponentMask&);
+            void addColumn(ArchetypeTable&, Component::ID);
+            void setPlacement();
+            void removeRow(ArchetypeTable&, std::uint32_t);
+        };
+
+        //used by the EntityManager to add pools of grouped components when they are created
+        template <class T>
+        void addGroupedPool(ArchetypeStorage& storage, Component::ID id, GroupedPool<T>& pool)
+        {
+            storage.addPool(id, pool);
+        }
+
+        template <class P>
+        void addGroupedPool(ArchetypeStorage&, Component::ID, P&) {}
+    }
+}
+
+#endif //XY_ARCHETYPE_STORAGE_HPP_
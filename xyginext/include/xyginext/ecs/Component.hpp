@@ -36,9 +36,24 @@ source distribution.
 #include <vector>
 #include <typeindex>
 #include <algorithm>
+#include <type_traits>
+#include <cstring>
+#include <bitset>
 
 namespace xy
 {
+    namespace Detail
+    {
+        class Pool;
+
+        enum
+        {
+            MaxComponents = 64 //this is max number of types on a single entity
+        };
+    }
+
+    using ComponentMask = std::bitset<Detail::MaxComponents>;
+
     class XY_EXPORT_API Component final
     {
     public:
@@ -46,18 +61,234 @@ namespace xy
         using ID = sf::Uint32;
 
         /*!
-        \brief Returns a unique ID based on the component type
+        \brief Returns a unique ID based on the component type.
+        The ID is looked up once per type and cached, so subsequent
+        calls are effectively free.
         */
         template <typename T>
         static ID getID()
         {
-            auto id = std::type_index(typeid(T));
-            return getFromTypeID(id);
+            //the registry is still consulted the first time so that
+            //IDs remain consistent across module boundaries
+            static const ID id = getFromTypeID(std::type_index(typeid(T)));
+            return id;
         }
 
     private:
         static ID getFromTypeID(std::type_index);
     };
+
+    /*!
+    \brief Storage trait for component types.
+    By default components are stored in a pool indexed directly by entity
+    index, which is fast but reserves a slot for every entity in the Scene.
+    Components which are large, or are only used by a few entities, can
+    instead be stored in a sparse set, where memory scales with the number
+    of components rather than the number of entities. To do so specialise
+    this trait for the component type before any entities are created:
+    \code
+    namespace xy
+    {
+        template <>
+        struct UseSparseStorage<MyBigComponent> : std::true_type {};
+    }
+    \endcode
+    */
+    template <typename T>
+    struct UseSparseStorage : std::false_type {};
+
+    /*!
+    \brief Storage trait for component types.
+    Components which use chunked storage are grouped by component mask:
+    every entity with exactly the same set of components is stored in the
+    same table, whose columns keep each chunked component type in fixed size
+    chunks. Views over chunked components walk the matching tables and read
+    each column linearly, however the entities were created or destroyed.
+    Components added to an entity are staged in their pool until the Scene
+    next updates, at which point the entity is moved to the table for its
+    new mask. References to chunked components are therefore only valid
+    until the next Scene update, but are never invalidated by creating
+    other entities. This is best suited to small components which are
+    iterated every frame by systems with the same requirements. Specialise
+    it in the same way as UseSparseStorage.
+    */
+    template <typename T>
+    struct UseChunkedStorage : std::false_type {};
+
+    /*!
+    \brief Change tracking trait for component types.
+    Any component type can be explicitly marked as changed with
+    Entity::markChanged(), so that systems can process only those
+    entities whose components changed with System::getChanged().
+    Component types which specialise this trait are also marked
+    automatically whenever they are added to an entity or accessed
+    via the non-const version of Entity::getComponent(). Note that
+    Views never mark components as changed.
+    \code
+    namespace xy
+    {
+        template <>
+        struct TrackChanges<MyComponent> : std::true_type {};
+    }
+    \endcode
+    */
+    template <typename T>
+    struct TrackChanges : std::false_type {};
+
+    /*!
+    \brief Used when duplicating components, for example when
+    instancing a Prefab. By default components are copy constructed.
+    Component types which cannot be copy constructed, but whose state
+    can still be usefully duplicated, should specialise this with a
+    static copy() function returning a new instance.
+    */
+    template <typename T>
+    struct ComponentCopy
+    {
+        static T copy(const T& component) { return T(component); }
+    };
+
+    /*!
+    \brief Bounds checked access to the component data of a Snapshot,
+    passed to ComponentSerialiser::read()
+    */
+    class SnapshotReader final
+    {
+    public:
+        SnapshotReader(const char* data, std::size_t size, std::size_t entityCount)
+            : m_position(data), m_end(data + size), m_entityCount(entityCount) {}
+
+        /*!
+        \brief Copies size bytes to dst and advances past them.
+        \returns false, without copying anything, if fewer than size bytes remain
+        */
+        bool read(void* dst, std::size_t size)
+        {
+            if (getRemaining() < size)
+            {
+                return false;
+            }
+            std::memcpy(dst, m_position, size);
+            m_position += size;
+            return true;
+        }
+
+        /*!
+        \brief Reads a trivially copyable value
+        \returns false if there are not enough bytes left
+        */
+        template <typename T>
+        bool read(T& value)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable values can be read directly");
+            return read(static_cast<void*>(&value), sizeof(T));
+        }
+
+        /*!
+        \brief Returns the number of bytes left to read
+        */
+        std::size_t getRemaining() const { return static_cast<std::size_t>(m_end - m_position); }
+
+        /*!
+        \brief Returns the number of entity slots in the snapshot. Entity
+        indices read from the snapshot must be less than this to be valid.
+        */
+        std::size_t getEntityCount() const { return m_entityCount; }
+
+    private:
+        const char* m_position;
+        const char* m_end;
+        std::size_t m_entityCount;
+    };
+
+    /*!
+    \brief Used when writing components to, or reading them from, a Snapshot.
+    By default components are left out of snapshots. Component types are
+    included by specialising this with write() and read() functions:
+    \code
+    namespace xy
+    {
+        template <>
+        struct ComponentSerialiser<MyComponent> : std::true_type
+        {
+            //append the component's state to dst
+            static void write(const MyComponent&, std::vector<char>& dst);
+            //restore the component's state from src, returning false if
+            //the data is truncated or otherwise invalid
+            static bool read(MyComponent&, SnapshotReader& src);
+        };
+    }
+    \endcode
+    Snapshot data may come from a file or over the network, so read() must
+    check any counts or entity indices it reads before using them.
+    Components which refer to each other, such as the parent and children
+    of a Transform, can be checked against the rest of the snapshot by
+    also providing a validate() function. It is passed every component of
+    that type read from the snapshot, along with the index of the entity
+    each belongs to, before any of them are restored:
+    \code
+    static bool validate(const std::vector<MyComponent>&, const std::vector<sf::Uint32>& entities);
+    \endcode
+    Components which contain only plain values, and no pointers or handles
+    to resources, can instead be copied byte for byte by specialising it as
+    a ByteSerialiser:
+    \code
+    template <>
+    struct ComponentSerialiser<MyComponent> : ByteSerialiser<MyComponent> {};
+    \endcode
+    Components read from a snapshot onto an entity which already has that
+    component are updated in place, and are otherwise default constructed
+    before being read.
+    \see Snapshot
+    */
+    template <typename T>
+    struct ComponentSerialiser : std::false_type {};
+
+    /*!
+    \brief Serialises a component by copying it byte for byte.
+    \see ComponentSerialiser
+    */
+    template <typename T>
+    struct ByteSerialiser : std::true_type
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable components can be copied byte for byte");
+        static_assert(std::is_default_constructible<T>::value, "Components read from snapshots must be default constructible");
+
+        static void write(const T& component, std::vector<char>& dst)
+        {
+            const auto* bytes = reinterpret_cast<const char*>(&component);
+            dst.insert(dst.end(), bytes, bytes + sizeof(T));
+        }
+
+        static bool read(T& component, SnapshotReader& src)
+        {
+            return src.read(static_cast<void*>(&component), sizeof(T));
+        }
+    };
+
+    /*!
+    \brief Used by component types which need to know which entity they
+    belong to, for example to refer to other components of the same type
+    by entity index rather than by pointer, as pointers are invalidated
+    when components are moved within their pool. attach() is called each
+    time a component is placed in its pool, and detach() when it is removed
+    from its entity or the entity is destroyed. A component's destructor
+    is not necessarily called when it is removed.
+    \code
+    namespace xy
+    {
+        template <>
+        struct ComponentAttachment<MyComponent> : std::true_type
+        {
+            //pool is the Detail::PoolType<MyComponent> which stores the component
+            static void attach(MyComponent&, std::size_t entityIndex, Detail::Pool& pool);
+            static void detach(MyComponent&);
+        };
+    }
+    \endcode
+    */
+    template <typename T>
+    struct ComponentAttachment : std::false_type {};
 }
 
 #endif //XY_COMPONENT_HPP_
@@ -29,8 +29,18 @@ source distribution.
 #define XY_POOL_HPP_
 
 #include <xyginext/core/Assert.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <new>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
 
 namespace xy
 {
@@ -41,8 +51,69 @@ namespace xy
 		public:
 			virtual ~Pool() = default;
 			virtual void clear() = 0;
+
+			/*!
+			\brief Called when the entity at the given index is destroyed
+			*/
+			virtual void remove(std::size_t) = 0;
 		};
 
+		/*!
+		\brief Copies a component into existing storage. Trivially
+		copyable components are copied with memcpy, others via ComponentCopy
+		*/
+		template <class T>
+		void copyComponent(T& dst, const T& src, std::true_type)
+		{
+			std::memcpy(&dst, &src, sizeof(T));
+		}
+
+		template <class T>
+		void copyComponent(T& dst, const T& src, std::false_type)
+		{
+			dst = ComponentCopy<T>::copy(src);
+		}
+
+		template <class T>
+		void copyComponent(T& dst, const T& src)
+		{
+			copyComponent(dst, src, std::is_trivially_copyable<T>());
+		}
+
+		/*!
+		\brief Notifies components which specialise ComponentAttachment
+		that they have been placed in, or removed from, a pool
+		*/
+		template <class T>
+		void attachComponent(T& component, std::size_t idx, Pool& pool, std::true_type)
+		{
+			ComponentAttachment<T>::attach(component, idx, pool);
+		}
+
+		template <class T>
+		void attachComponent(T&, std::size_t, Pool&, std::false_type) {}
+
+		template <class T>
+		void attachComponent(T& component, std::size_t idx, Pool& pool)
+		{
+			attachComponent(component, idx, pool, ComponentAttachment<T>());
+		}
+
+		template <class T>
+		void detachComponent(T& component, std::true_type)
+		{
+			ComponentAttachment<T>::detach(component);
+		}
+
+		template <class T>
+		void detachComponent(T&, std::false_type) {}
+
+		template <class T>
+		void detachComponent(T& component)
+		{
+			detachComponent(component, ComponentAttachment<T>());
+		}
+
 		/*!
 		\brief memory pooling for components - TODO map component to ID
 		*/
@@ -55,9 +126,16 @@ namespace xy
 			bool empty() const { return m_pool.empty(); }
 			std::size_t size() const { return m_pool.size(); }
 			void resize(std::size_t size) { m_pool.resize(size); }
-			void clear() { m_pool.clear(); }
+			void clear() override { m_pool.clear(); }
 			void add(T c) { m_pool.push_back(c); }
 
+			void insert(std::size_t idx, T&& c) { m_pool[idx] = std::move(c); attachComponent(m_pool[idx], idx, *this); }
+			void insertCopy(std::size_t idx, const T& c) { copyComponent(m_pool[idx], c); attachComponent(m_pool[idx], idx, *this); }
+			//makes sure indices up to size are valid before inserting a batch of components
+			void prepare(std::size_t size, std::size_t) { if (size > m_pool.size()) resize(size); }
+			//components remain in place until their slot is reused
+			void remove(std::size_t idx) override { detachComponent(m_pool[idx]); }
+
             T& at(std::size_t idx) { return m_pool[idx]; }
             const T& at(std::size_t idx) const { return m_pool[idx]; }
 
@@ -67,6 +145,694 @@ namespace xy
 		private:
 			std::vector<T> m_pool;
 		};
+
+		/*!
+		\brief Sparse set storage for components.
+		Entity indices map through a sparse array to a densely packed
+		array of components, so memory scales with the number of components
+		rather than the number of entities. Iterating begin()/end() walks
+		only the packed components, and getIndices() returns the entity
+		index of each packed component in the same order.
+		\see UseSparseStorage
+		*/
+		template <class T>
+		class SparsePool final : public Pool
+		{
+		public:
+			using Index = std::uint32_t;
+			static constexpr Index Invalid = std::numeric_limits<Index>::max();
+
+			explicit SparsePool(std::size_t size = 100) { resize(size); }
+
+			bool empty() const { return m_dense.empty(); }
+			//returns the number of entity indices currently mapped
+			std::size_t size() const { return m_sparse.size(); }
+			//returns the number of components actually stored
+			std::size_t count() const { return m_dense.size(); }
+			void resize(std::size_t size) { if (size > m_sparse.size()) m_sparse.resize(size, Invalid); }
+			void reserve(std::size_t count) { m_dense.reserve(count); m_indices.reserve(count); }
+			void clear() override
+			{
+				m_dense.clear();
+				m_indices.clear();
+				std::fill(m_sparse.begin(), m_sparse.end(), Invalid);
+			}
+
+			void insert(std::size_t idx, T&& c)
+			{
+				resize(idx + 1);
+				if (m_sparse[idx] != Invalid)
+				{
+					m_dense[m_sparse[idx]] = std::move(c);
+					attachComponent(m_dense[m_sparse[idx]], idx, *this);
+					return;
+				}
+				m_sparse[idx] = static_cast<Index>(m_dense.size());
+				m_dense.push_back(std::move(c));
+				m_indices.push_back(static_cast<Index>(idx));
+				attachComponent(m_dense.back(), idx, *this);
+			}
+
+			void insertCopy(std::size_t idx, const T& c)
+			{
+				resize(idx + 1);
+				if (m_sparse[idx] != Invalid)
+				{
+					copyComponent(m_dense[m_sparse[idx]], c);
+					attachComponent(m_dense[m_sparse[idx]], idx, *this);
+					return;
+				}
+				m_sparse[idx] = static_cast<Index>(m_dense.size());
+				m_dense.push_back(ComponentCopy<T>::copy(c));
+				m_indices.push_back(static_cast<Index>(idx));
+				attachComponent(m_dense.back(), idx, *this);
+			}
+
+			//makes sure indices up to size are valid and there is room for
+			//the given number of additional components before inserting a batch
+			void prepare(std::size_t size, std::size_t additional)
+			{
+				resize(size);
+				reserve(m_dense.size() + additional);
+			}
+
+			void remove(std::size_t idx) override
+			{
+				if (!contains(idx)) return;
+
+				//move the last component into the hole. The old component is
+				//destroyed first rather than assigned over so that components
+				//which aren't move assignable can still be stored sparsely.
+				const auto slot = m_sparse[idx];
+				detachComponent(m_dense[slot]);
+				const auto last = static_cast<Index>(m_dense.size() - 1);
+				if (slot != last)
+				{
+					m_dense[slot].~T();
+					new (&m_dense[slot]) T(std::move(m_dense[last]));
+					m_indices[slot] = m_indices[last];
+					m_sparse[m_indices[slot]] = slot;
+				}
+				m_dense.pop_back();
+				m_indices.pop_back();
+				m_sparse[idx] = Invalid;
+			}
+
+			bool contains(std::size_t idx) const { return idx < m_sparse.size() && m_sparse[idx] != Invalid; }
+
+			T& at(std::size_t idx) { XY_ASSERT(contains(idx), "Component does not exist"); return m_dense[m_sparse[idx]]; }
+			const T& at(std::size_t idx) const { XY_ASSERT(contains(idx), "Component does not exist"); return m_dense[m_sparse[idx]]; }
+
+			T& operator [] (std::size_t index) { return at(index); }
+			const T& operator [] (std::size_t index) const { return at(index); }
+
+			typename std::vector<T>::iterator begin() { return m_dense.begin(); }
+			typename std::vector<T>::iterator end() { return m_dense.end(); }
+			typename std::vector<T>::const_iterator begin() const { return m_dense.begin(); }
+			typename std::vector<T>::const_iterator end() const { return m_dense.end(); }
+
+			const std::vector<Index>& getIndices() const { return m_indices; }
+
+		private:
+			std::vector<Index> m_sparse;
+			std::vector<T> m_dense;
+			std::vector<Index> m_indices;
+		};
+
+		template <class T>
+		constexpr typename SparsePool<T>::Index SparsePool<T>::Invalid;
+
+		/*!
+		\brief Base class for the columns of an ArchetypeTable.
+		Each column stores the components of one type for every row of
+		its table, in fixed size chunks which are never reallocated.
+		Rows are added to and removed from the end of the column.
+		\see ArchetypeStorage
+		*/
+		class ArchetypeColumn
+		{
+		public:
+			static constexpr std::size_t ChunkShift = 8;
+			static constexpr std::size_t ChunkSize = std::size_t(1) << ChunkShift;
+			static constexpr std::size_t ChunkMask = ChunkSize - 1;
+
+			virtual ~ArchetypeColumn() = default;
+
+			//adds a row by moving the component in srcRow of src, which must store the same type
+			virtual void pushFrom(ArchetypeColumn& src, std::size_t srcRow, std::size_t entity) = 0;
+			//adds a row by moving the entity's staged component out of its pool
+			virtual void pushStaged(std::size_t entity) = 0;
+			//replaces the component in an existing row with the entity's staged component
+			virtual void replaceStaged(std::size_t entity, std::size_t row) = 0;
+			//destroys the component in a row, leaving the row to be filled or truncated
+			virtual void destroyRow(std::size_t row) = 0;
+			//fills a destroyed row by moving the last row, which belongs to the given entity, into it
+			virtual void fillRow(std::size_t row, std::size_t lastEntity) = 0;
+			//removes every row from the given row onwards, all of which must have been destroyed
+			virtual void truncate(std::size_t size) = 0;
+			//returns the number of rows in the column
+			virtual std::size_t size() const = 0;
+		};
+
+		/*!
+		\brief Interface to pools of grouped components used by ArchetypeStorage.
+		Newly added components are staged in their pool until the entity
+		is next moved to the table which matches its component mask.
+		*/
+		class StagedPool : public Pool
+		{
+		public:
+			/*!
+			\brief Returns true if the entity's component is waiting to be moved to a table
+			*/
+			virtual bool isStaged(std::size_t idx) const = 0;
+
+			/*!
+			\brief Returns the number of components waiting to be moved to a table
+			*/
+			virtual std::size_t getStagedCount() const = 0;
+
+			/*!
+			\brief Creates an empty column for this component type
+			*/
+			virtual std::unique_ptr<ArchetypeColumn> createColumn() = 0;
+
+			/*!
+			\brief Sets the column in which new components are constructed
+			directly, rather than being staged, or nullptr to stage them again
+			*/
+			virtual void setPlacement(ArchetypeColumn*) = 0;
+		};
+
+		/*!
+		\brief Uninitialised storage for components, used by grouped storage so
+		that components are only constructed when they are moved into place
+		*/
+		template <class T>
+		class ChunkStorage final
+		{
+		public:
+			using Block = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+			using Chunk = std::unique_ptr<Block[]>;
+
+			//adds a chunk to the end of the storage
+			void addChunk(Chunk chunk) { m_chunks.push_back(std::move(chunk)); }
+
+			//removes the last chunk, which must not contain any components
+			Chunk removeChunk()
+			{
+				auto chunk = std::move(m_chunks.back());
+				m_chunks.pop_back();
+				return chunk;
+			}
+
+			std::size_t capacity() const { return m_chunks.size() << ArchetypeColumn::ChunkShift; }
+
+			void* get(std::size_t idx) const { return &m_chunks[idx >> ArchetypeColumn::ChunkShift][idx & ArchetypeColumn::ChunkMask]; }
+			T& at(std::size_t idx) const { return *reinterpret_cast<T*>(get(idx)); }
+
+			T* getChunk(std::size_t chunk) const { return reinterpret_cast<T*>(m_chunks[chunk].get()); }
+
+		private:
+			std::vector<Chunk> m_chunks;
+		};
+
+		template <class T>
+		class GroupedPool;
+
+		template <class T>
+		class ArchetypeColumnImpl final : public ArchetypeColumn
+		{
+		public:
+			explicit ArchetypeColumnImpl(GroupedPool<T>& pool) : m_pool(pool), m_size(0) {}
+
+			~ArchetypeColumnImpl()
+			{
+				for (auto i = 0u; i < m_size; ++i)
+				{
+					m_storage.at(i).~T();
+				}
+			}
+
+			ArchetypeColumnImpl(const ArchetypeColumnImpl&) = delete;
+			ArchetypeColumnImpl& operator = (const ArchetypeColumnImpl&) = delete;
+
+			void pushFrom(ArchetypeColumn& src, std::size_t srcRow, std::size_t entity) override
+			{
+				m_pool.relocate(entity, push(std::move(static_cast<ArchetypeColumnImpl<T>&>(src).at(srcRow))));
+			}
+
+			void pushStaged(std::size_t entity) override
+			{
+				auto& staged = m_pool.getStaged(entity);
+				auto& component = push(std::move(staged));
+				staged.~T();
+				m_pool.releaseStaged(entity);
+				m_pool.relocate(entity, component);
+			}
+
+			void replaceStaged(std::size_t entity, std::size_t row) override
+			{
+				auto& staged = m_pool.getStaged(entity);
+				auto& component = at(row);
+				component = std::move(staged);
+				staged.~T();
+				m_pool.releaseStaged(entity);
+				m_pool.relocate(entity, component);
+			}
+
+			void destroyRow(std::size_t row) override
+			{
+				at(row).~T();
+			}
+
+			void fillRow(std::size_t row, std::size_t lastEntity) override
+			{
+				auto& last = at(--m_size);
+				m_pool.relocate(lastEntity, *new (m_storage.get(row)) T(std::move(last)));
+				last.~T();
+				releaseEmptyChunks();
+			}
+
+			void truncate(std::size_t size) override
+			{
+				m_size = size;
+				releaseEmptyChunks();
+			}
+
+			std::size_t size() const override { return m_size; }
+
+			T& at(std::size_t row) { return m_storage.at(row); }
+
+			/*!
+			\brief Adds a row and returns the uninitialised storage for its
+			component, which must be constructed before the column is next used
+			*/
+			void* append()
+			{
+				if (m_size == m_storage.capacity())
+				{
+					m_storage.addChunk(m_pool.acquireChunk());
+				}
+				return m_storage.get(m_size++);
+			}
+
+			/*!
+			\brief Returns the component in the first row of the given chunk
+			*/
+			T* getChunk(std::size_t chunk) const { return m_storage.getChunk(chunk); }
+
+		private:
+			GroupedPool<T>& m_pool;
+			ChunkStorage<T> m_storage;
+			std::size_t m_size;
+
+			T& push(T&& c)
+			{
+				return *new (append()) T(std::move(c));
+			}
+
+			//chunks left empty are given back to the pool for reuse
+			void releaseEmptyChunks()
+			{
+				while (m_storage.capacity() - m_size > ArchetypeColumn::ChunkMask)
+				{
+					m_pool.releaseChunk(m_storage.removeChunk());
+				}
+			}
+		};
+
+		/*!
+		\brief Grouped storage for components.
+		Components live in the columns of the ArchetypeTable matching their
+		entity's component mask, so that entities with the same mask are
+		packed together. Each entity index maps directly to its component,
+		wherever it currently lives, so that random access costs the same
+		as ComponentPool. Components added since the Scene last updated
+		are staged in the pool until their entity is moved to a table,
+		unless the entity is being placed in its table by a Prefab.
+		\see UseChunkedStorage
+		*/
+		template <class T>
+		class GroupedPool final : public StagedPool
+		{
+		public:
+			using Slot = std::uint32_t;
+			static constexpr Slot NoSlot = std::numeric_limits<Slot>::max();
+
+			explicit GroupedPool(std::size_t size = 100)
+				: m_stagingChunk(NoSlot), m_stagingRow(0), m_stagedCount(0), m_placement(nullptr) { resize(size); }
+
+			~GroupedPool() { clear(); }
+
+			GroupedPool(const GroupedPool&) = delete;
+			GroupedPool& operator = (const GroupedPool&) = delete;
+
+			bool empty() const { return m_components.empty(); }
+			std::size_t size() const { return m_components.size(); }
+			void resize(std::size_t size)
+			{
+				if (size > m_components.size())
+				{
+					m_components.resize(size, nullptr);
+					m_staged.resize(size, NoSlot);
+				}
+			}
+
+			//components in tables are owned by the ArchetypeStorage
+			void clear() override
+			{
+				for (auto i = 0u; i < m_staged.size(); ++i)
+				{
+					if (m_staged[i] != NoSlot)
+					{
+						getStaged(i).~T();
+						releaseStaged(i);
+					}
+				}
+				std::fill(m_components.begin(), m_components.end(), nullptr);
+			}
+
+			void insert(std::size_t idx, T&& c)
+			{
+				resize(idx + 1);
+				if (m_components[idx])
+				{
+					*m_components[idx] = std::move(c);
+				}
+				else
+				{
+					m_components[idx] = new (allocate(idx)) T(std::move(c));
+				}
+				attachComponent(*m_components[idx], idx, *this);
+			}
+
+			void insertCopy(std::size_t idx, const T& c)
+			{
+				resize(idx + 1);
+				if (m_components[idx])
+				{
+					copyComponent(*m_components[idx], c);
+				}
+				else
+				{
+					m_components[idx] = constructCopy(allocate(idx), c, std::is_trivially_copyable<T>());
+				}
+				attachComponent(*m_components[idx], idx, *this);
+			}
+
+			//makes sure indices up to size are valid before inserting a batch of components
+			void prepare(std::size_t size, std::size_t) { resize(size); }
+
+			//a component in a table stays in place until the entity is next
+			//moved, but can no longer be accessed through the pool
+			void remove(std::size_t idx) override
+			{
+				if (idx >= m_components.size() || !m_components[idx]) return;
+
+				detachComponent(*m_components[idx]);
+				if (m_staged[idx] != NoSlot)
+				{
+					getStaged(idx).~T();
+					releaseStaged(idx);
+				}
+				m_components[idx] = nullptr;
+			}
+
+			T& at(std::size_t idx) { XY_ASSERT(m_components[idx], "Component does not exist"); return *m_components[idx]; }
+			const T& at(std::size_t idx) const { XY_ASSERT(m_components[idx], "Component does not exist"); return *m_components[idx]; }
+
+			T& operator [] (std::size_t index) { return at(index); }
+			const T& operator [] (std::size_t index) const { return at(index); }
+
+			bool isStaged(std::size_t idx) const override { return idx < m_staged.size() && m_staged[idx] != NoSlot; }
+			std::size_t getStagedCount() const override { return m_stagedCount; }
+			std::unique_ptr<ArchetypeColumn> createColumn() override { return std::make_unique<ArchetypeColumnImpl<T>>(*this); }
+			void setPlacement(ArchetypeColumn* column) override { m_placement = static_cast<ArchetypeColumnImpl<T>*>(column); }
+
+		private:
+			std::vector<T*> m_components; //< indexed by entity, nullptr if the entity has no component
+			std::vector<Slot> m_staged; //< staging slot of each entity's component, or NoSlot
+			std::vector<typename ChunkStorage<T>::Chunk> m_stagingChunks; //< nullptr if the chunk is empty
+			std::vector<std::uint32_t> m_chunkStagedCounts;
+			std::vector<Slot> m_freeChunks; //< indices of empty staging chunks
+			Slot m_stagingChunk; //< chunk components are currently staged in
+			std::size_t m_stagingRow; //< next free row of m_stagingChunk
+			std::size_t m_stagedCount;
+			std::vector<typename ChunkStorage<T>::Chunk> m_spareChunks; //< empty chunks shared by staging and columns
+			ArchetypeColumnImpl<T>* m_placement; //< column new components are appended to, if entities are being placed
+
+			static T* constructCopy(void* dst, const T& src, std::true_type)
+			{
+				std::memcpy(dst, &src, sizeof(T));
+				return reinterpret_cast<T*>(dst);
+			}
+
+			static T* constructCopy(void* dst, const T& src, std::false_type)
+			{
+				return new (dst) T(ComponentCopy<T>::copy(src));
+			}
+
+			//returns uninitialised storage for the entity's staged component. Components
+			//are staged in the same chunk until it's full, and each chunk is released
+			//as soon as it's empty, so that the columns the components are moved to
+			//can reuse the staging chunks rather than allocating new ones.
+			void* stage(std::size_t idx)
+			{
+				if (m_stagingChunk == NoSlot || m_stagingRow == ArchetypeColumn::ChunkSize)
+				{
+					if (m_freeChunks.empty())
+					{
+						m_freeChunks.push_back(static_cast<Slot>(m_stagingChunks.size()));
+						m_stagingChunks.emplace_back();
+						m_chunkStagedCounts.push_back(0);
+					}
+					m_stagingChunk = m_freeChunks.back();
+					m_freeChunks.pop_back();
+					m_stagingChunks[m_stagingChunk] = acquireChunk();
+					m_stagingRow = 0;
+				}
+				m_staged[idx] = static_cast<Slot>((m_stagingChunk << ArchetypeColumn::ChunkShift) + m_stagingRow++);
+				m_chunkStagedCounts[m_stagingChunk]++;
+				m_stagedCount++;
+				return getSlot(m_staged[idx]);
+			}
+
+			void* getSlot(Slot slot) const
+			{
+				return &m_stagingChunks[slot >> ArchetypeColumn::ChunkShift][slot & ArchetypeColumn::ChunkMask];
+			}
+
+			//returns uninitialised storage for the entity's new component, at the
+			//end of the column being placed into if there is one, else staged
+			void* allocate(std::size_t idx)
+			{
+				return m_placement ? m_placement->append() : stage(idx);
+			}
+
+			T& getStaged(std::size_t idx) { return *reinterpret_cast<T*>(getSlot(m_staged[idx])); }
+
+			//the staged component is expected to have been moved from or destroyed
+			void releaseStaged(std::size_t idx)
+			{
+				const auto chunk = m_staged[idx] >> ArchetypeColumn::ChunkShift;
+				if (--m_chunkStagedCounts[chunk] == 0)
+				{
+					if (chunk == m_stagingChunk)
+					{
+						m_stagingRow = 0;
+					}
+					else
+					{
+						releaseChunk(std::move(m_stagingChunks[chunk]));
+						m_freeChunks.push_back(chunk);
+					}
+				}
+				m_staged[idx] = NoSlot;
+				m_stagedCount--;
+			}
+
+			typename ChunkStorage<T>::Chunk acquireChunk()
+			{
+				if (m_spareChunks.empty())
+				{
+					return std::make_unique<typename ChunkStorage<T>::Block[]>(ArchetypeColumn::ChunkSize);
+				}
+				auto chunk = std::move(m_spareChunks.back());
+				m_spareChunks.pop_back();
+				return chunk;
+			}
+
+			void releaseChunk(typename ChunkStorage<T>::Chunk chunk) { m_spareChunks.push_back(std::move(chunk)); }
+
+			//called when a column moves the entity's component. Components which
+			//were removed, or which have been staged again, aren't followed.
+			void relocate(std::size_t idx, T& component)
+			{
+				if (m_components[idx] && m_staged[idx] == NoSlot)
+				{
+					m_components[idx] = &component;
+				}
+			}
+
+			friend class ArchetypeColumnImpl<T>;
+		};
+
+		template <class T>
+		constexpr typename GroupedPool<T>::Slot GroupedPool<T>::NoSlot;
+
+		/*!
+		\brief Selects the pool type for a component based on its storage traits
+		*/
+		template <class T>
+		using PoolType = typename std::conditional<UseSparseStorage<T>::value, SparsePool<T>,
+			typename std::conditional<UseChunkedStorage<T>::value, GroupedPool<T>, ComponentPool<T>>::type>::type;
+
+		/*!
+		\brief Type erased access to the components in a pool, used
+		when writing and reading Snapshots.
+		\see ComponentSerialiser
+		*/
+		class PoolSerialiser
+		{
+		public:
+			virtual ~PoolSerialiser() = default;
+
+			/*!
+			\brief Returns a name identifying the component type in a snapshot
+			*/
+			virtual const char* getName() const = 0;
+
+			/*!
+			\brief Appends the component at the given index to dst
+			*/
+			virtual void write(std::size_t idx, std::vector<char>& dst) const = 0;
+
+			/*!
+			\brief Reads the component at the given index from src. If the
+			component doesn't exist in the pool it is created.
+			\returns false if the data is invalid, in which case nothing is created
+			*/
+			virtual bool read(std::size_t idx, SnapshotReader& src, bool exists) = 0;
+
+			/*!
+			\brief Reads the components of the given entities from src without
+			storing them, to check that the data can be read before restoring
+			any of it
+			\returns false if the data is invalid
+			*/
+			virtual bool validate(SnapshotReader& src, const std::vector<sf::Uint32>& entities) const = 0;
+
+			/*!
+			\brief Makes sure indices up to size are valid
+			*/
+			virtual void prepare(std::size_t size) = 0;
+
+			/*!
+			\brief Returns true if the component type tracks changes
+			\see TrackChanges
+			*/
+			virtual bool tracksChanges() const = 0;
+		};
+
+		/*!
+		\brief Detects serialisers which provide a validate() function
+		\see ComponentSerialiser
+		*/
+		template <class T>
+		struct ValidatesSnapshot final
+		{
+			template <class U>
+			static auto test(int) -> decltype(ComponentSerialiser<U>::validate(std::declval<const std::vector<U>&>(),
+				std::declval<const std::vector<sf::Uint32>&>()), std::true_type());
+
+			template <class>
+			static std::false_type test(...);
+
+			using type = decltype(test<T>(0));
+		};
+
+		template <class T>
+		class PoolSerialiserImpl final : public PoolSerialiser
+		{
+		public:
+			explicit PoolSerialiserImpl(PoolType<T>& pool) : m_pool(pool) {}
+
+			const char* getName() const override { return typeid(T).name(); }
+
+			void write(std::size_t idx, std::vector<char>& dst) const override
+			{
+				ComponentSerialiser<T>::write(m_pool.at(idx), dst);
+			}
+
+			bool read(std::size_t idx, SnapshotReader& src, bool exists) override
+			{
+				if (exists)
+				{
+					return ComponentSerialiser<T>::read(m_pool.at(idx), src);
+				}
+
+				T component;
+				if (!ComponentSerialiser<T>::read(component, src))
+				{
+					return false;
+				}
+				m_pool.insert(idx, std::move(component));
+				return true;
+			}
+
+			bool validate(SnapshotReader& src, const std::vector<sf::Uint32>& entities) const override
+			{
+				return validate(src, entities, typename ValidatesSnapshot<T>::type());
+			}
+
+			void prepare(std::size_t size) override { m_pool.prepare(size, 0); }
+
+			bool tracksChanges() const override { return TrackChanges<T>::value; }
+
+		private:
+			PoolType<T>& m_pool;
+
+			bool validate(SnapshotReader& src, const std::vector<sf::Uint32>& entities, std::false_type) const
+			{
+				T component;
+				for (auto i = 0u; i < entities.size(); ++i)
+				{
+					if (!ComponentSerialiser<T>::read(component, src))
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+
+			//components are kept so that they can be checked against each other
+			bool validate(SnapshotReader& src, const std::vector<sf::Uint32>& entities, std::true_type) const
+			{
+				std::vector<T> components(entities.size());
+				for (auto& component : components)
+				{
+					if (!ComponentSerialiser<T>::read(component, src))
+					{
+						return false;
+					}
+				}
+				return ComponentSerialiser<T>::validate(components, entities);
+			}
+		};
+
+		template <class T>
+		std::unique_ptr<PoolSerialiser> createSerialiser(PoolType<T>& pool, std::true_type)
+		{
+			return std::make_unique<PoolSerialiserImpl<T>>(pool);
+		}
+
+		//component types which can't be serialised have no serialiser
+		template <class T>
+		std::unique_ptr<PoolSerialiser> createSerialiser(PoolType<T>&, std::false_type)
+		{
+			return nullptr;
+		}
 	}
 }
 
@@ -31,6 +31,8 @@ source distribution.
 #include <xyginext/Config.hpp>
 #include <xyginext/core/MessageBus.hpp>
 
+#include <vector>
+
 namespace xy
 {
     class Message;
@@ -62,7 +64,10 @@ namespace xy
 
     protected:
         /*!
-        \brief Implement to handle system messages
+        \brief Implement to handle system messages. Only messages with
+        an ID to which the Director has subscribed are passed to this
+        function.
+        \see subscribe()
         */
         virtual void handleMessage(const Message&) = 0;
 
@@ -93,12 +98,27 @@ namespace xy
         */
         Scene& getScene();
 
+        /*!
+        \brief Subscribes the Director to messages with the given ID, so
+        that they are passed to handleMessage(). Subscriptions must be made
+        in the Director's constructor.
+        */
+        void subscribe(Message::ID);
+
+        /*!
+        \brief Subscribes the Director to every message posted on the MessageBus.
+        */
+        void subscribeAll();
+
     private:
 
         MessageBus* m_messageBus;
         CommandSystem* m_commandSystem;
         Scene* m_scene;
 
+        bool m_subscribesAll;
+        std::vector<Message::ID> m_subscriptions;
+
         friend class Scene;
     };
 
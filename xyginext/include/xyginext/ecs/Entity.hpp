@@ -33,14 +33,16 @@ source distribution.
 
 #include <xyginext/ecs/ComponentPool.hpp>
 #include <xyginext/ecs/Component.hpp>
+#include <xyginext/ecs/ArchetypeStorage.hpp>
 
 #include <SFML/Config.hpp>
 
 #include <bitset>
 #include <vector>
-#include <deque>
 #include <memory>
 #include <limits>
+#include <mutex>
+#include <atomic>
 
 namespace xy
 {
@@ -48,27 +50,55 @@ namespace xy
 	{
 		enum
 		{
-			MaxComponents = 64, //this is max number of types on a single entity
+#ifdef XY_NARROW_ENTITY_HANDLES
 			IndexBits = 24,
 			GenerationBits = 8,
-			MinFreeIDs = 1024 //after this generation is incremented and we go back to zero
+#else
+			IndexBits = 32,
+			GenerationBits = 32,
+#endif //XY_NARROW_ENTITY_HANDLES
+			MinFreeIDs = 1024 //freed IDs are only reused once there are this many, to spread out generations
 		};
 	}
-	
-	using ComponentMask = std::bitset<Detail::MaxComponents>;
+
     class EntityManager;
 
+    namespace Detail
+    {
+        /*!
+        \brief Used in debug builds to assert that a system being processed
+        by the SystemManager on the calling thread has declared access to
+        the component with the given ID.
+        */
+        XY_EXPORT_API void checkComponentAccess(std::size_t componentID);
+    }
+
+    template <typename... Ts>
+    class View;
+
 	/*!
 	\brief Entity class - Basically just an ID.
 	The ID is generated as a combination of the index in the
 	memory pool and the generation - that is the nth time the
 	index has been used.
+	By default handles are 64 bit, with 32 bits each for the index
+	and generation. Defining XY_NARROW_ENTITY_HANDLES when building
+	both xygine and the application packs handles in to 32 bits
+	with 24 index bits and 8 generation bits instead. An index whose
+	generation reaches its maximum value is retired rather than
+	wrapping around, so that stale handles can never alias a new entity.
 	*/
 	class XY_EXPORT_API Entity final
 	{
 	public:
 		using ID = sf::Uint32;
+#ifdef XY_NARROW_ENTITY_HANDLES
 		using Generation = sf::Uint8;
+		using Handle = sf::Uint32;
+#else
+		using Generation = sf::Uint32;
+		using Handle = sf::Uint64;
+#endif //XY_NARROW_ENTITY_HANDLES
 
 		Entity(ID index = std::numeric_limits<ID>::max(), Generation generation = 0);
 
@@ -81,6 +111,11 @@ namespace xy
 		*/
 		Generation getGeneration() const;
 
+		/*!
+		\brief Returns the packed index and generation of this entity
+		*/
+		Handle getHandle() const { return m_id; }
+
 		/*!
 		\brief Marks the entity for destruction
 		*/
@@ -94,7 +129,9 @@ namespace xy
 
 		/*!
 		\brief Adds a copy of the given instance of a component to
-		the entity
+		the entity. If the entity is already part of a Scene it
+		will be added to any newly matching systems when the Scene
+		next updates.
 		*/
 		template <typename T>
 		void addComponent(const T&);
@@ -107,10 +144,13 @@ namespace xy
 		T& addComponent(Args&&...);
 
 		/*!
-		\brief Removes the component of this type if it exists
+		\brief Removes the component of this type if it exists.
+		The component remains valid until the Scene next updates,
+		at which point the entity is removed from any systems which
+		require the component, and the component is destroyed.
 		*/
-		/*template <typename T>
-		void removeComponent()*/;
+		template <typename T>
+		void removeComponent();
 
 		/*!
 		\brief returns true if the component type exists on thie entity
@@ -127,6 +167,14 @@ namespace xy
         template <typename T>
         const T& getComponent() const;
 
+        /*!
+        \brief Marks the component of this type as having changed
+        so that it is reported by System::getChanged()
+        \see TrackChanges
+        */
+        template <typename T>
+        void markChanged();
+
         /*!
         \brief Returns a reference to the CompnentMask associated with this entity
         */
@@ -169,12 +217,33 @@ namespace xy
         }
 	private:
 
-		ID m_id;
+		Handle m_id;
         EntityManager* m_entityManager;
         friend class EntityManager;
 	};
 
+    namespace Detail
+    {
+        /*!
+        \brief Records the entities whose component of a given
+        type was changed in the current and previous versions.
+        */
+        struct ChangeSet final
+        {
+            std::mutex mutex; //< guards current and previous
+            std::unique_ptr<std::atomic<sf::Uint32>[]> versions; //< version in which the component was last marked, indexed by entity ID
+            std::atomic<std::size_t> versionCount = { 0 }; //< only grows while no other thread is marking changes
+            std::vector<Entity> current;
+            std::vector<Entity> previous;
+        };
+    }
+
     class MessageBus;
+    class Snapshot;
+    namespace Detail
+    {
+        struct SnapshotLayout;
+    }
     /*!
     \brief Manages the relationship between an Entity and its components
     */
@@ -193,11 +262,25 @@ namespace xy
         \brief Creates a new Entity
         */
         Entity createEntity();
+
+        /*!
+        \brief Creates the given number of entities at once.
+        Storage for the new entities is allocated up front rather
+        than as each one is created.
+        */
+        std::vector<Entity> createEntities(std::size_t count);
         /*!
         \brief Destroys the given Entity
         */
         void destroyEntity(Entity);
         /*!
+        \brief Destroys each of the given entities which hasn't already been
+        destroyed. This is cheaper than destroying them one at a time, as
+        the rows they leave in the tables of grouped components are only
+        filled once all of them have been removed.
+        */
+        void destroyEntities(const std::vector<Entity>&);
+        /*!
         \brief Returns true if the entity is destroyed or marked for destruction
         */
         bool entityDestroyed(Entity) const;
@@ -206,6 +289,18 @@ namespace xy
         */
         Entity getEntity(Entity::ID) const;
 
+        /*!
+        \brief Returns the number of entity indices currently allocated,
+        including those which are free or retired
+        */
+        std::size_t getEntityCapacity() const { return m_slots.size(); }
+
+        /*!
+        \brief Returns the number of indices which have been permanently
+        retired because their generation reached its maximum value
+        */
+        std::size_t getRetiredCount() const { return m_retiredCount; }
+
         /*!
         \brief Adds a copy of the given component to the given Entity
         */
@@ -219,10 +314,21 @@ namespace xy
         T& addComponent(Entity, Args&&... args);
 
         /*!
-        \brief Removes this component type for the given Entity
+        \brief Adds a copy of the given component to each of the given entities.
+        The component pool is resized once for the whole batch, and trivially
+        copyable components are copied with memcpy.
+        \see ComponentCopy
+        */
+        template <typename T>
+        void addComponents(const std::vector<Entity>&, const T&);
+
+        /*!
+        \brief Marks this component type for removal from the given Entity.
+        Removal is deferred until applyChanges() so that the Scene can first
+        remove the entity from any systems which required the component.
         */
-        /*template <typename T>
-        void removeComponent(Entity);*/
+        template <typename T>
+        void removeComponent(Entity);
 
         /*!
         \brief Returns true if the given Entity has a component of this type
@@ -237,6 +343,49 @@ namespace xy
         template <typename T>
         T& getComponent(Entity);
 
+        template <typename T>
+        const T& getComponent(Entity) const;
+
+        /*!
+        \brief Marks the component of this type on the given entity as changed
+        in the current version. This is safe to call from multiple threads.
+        \see TrackChanges
+        */
+        template <typename T>
+        void markChanged(Entity);
+
+        /*!
+        \brief Marks the component with the given ID on the given entity as changed
+        */
+        void markChanged(Entity, Component::ID);
+
+        /*!
+        \brief Marks the component with the given ID on each of the given
+        entities as changed, locking the change list only once
+        */
+        void markChanged(const std::vector<Entity>&, Component::ID);
+
+        /*!
+        \brief Appends to the given list each living entity whose component with the
+        given ID was marked as changed in the given version or later.
+        Changes are only kept for the current and previous versions.
+        \returns false if the given version is older than the previous
+        version, in which case the list is incomplete.
+        */
+        bool getChanged(Component::ID, sf::Uint32 sinceVersion, std::vector<Entity>& dst) const;
+
+        /*!
+        \brief Returns the current change tracking version
+        */
+        sf::Uint32 getVersion() const { return m_version; }
+
+        /*!
+        \brief Starts a new change tracking version, discarding
+        any changes older than the version being ended.
+        This is called by the Scene at the start of each update.
+        */
+        void nextVersion();
+
         /*!
         \brief Returns a reference to the component mask of the given Entity.
         Component masks are used to identify whether an Entity has a particular component
@@ -248,15 +397,136 @@ namespace xy
         */
         bool owns(Entity) const;
 
+        /*!
+        \brief Marks the entity as having been added to systems.
+        Components subsequently added to or removed from the entity
+        will place it in the list of changed entities.
+        */
+        void setSubmitted(Entity);
+
+        /*!
+        \brief Returns a list of submitted entities which have had components
+        added, or marked for removal, since the last call to applyChanges()
+        */
+        const std::vector<Entity>& getChangedEntities() const { return m_changedEntities; }
+
+        /*!
+        \brief Returns the component mask the entity will have once
+        any pending component removals have been applied
+        */
+        ComponentMask getPendingMask(Entity) const;
+
+        /*!
+        \brief Destroys any components marked for removal, moves each
+        changed entity to the table for its new component mask, and
+        clears the list of changed entities
+        */
+        void applyChanges();
+
+        /*!
+        \brief Returns a View of all entities which own each of the given
+        component types.
+        \see View
+        */
+        template <typename... Ts>
+        View<Ts...> view();
+
+        /*!
+        \brief Returns a View over the given list of entities.
+        All entities in the list are assumed to own each of the given
+        component types, so no mask checking is done. This is used by
+        Systems to iterate their entity lists.
+        */
+        template <typename... Ts>
+        View<Ts...> view(const std::vector<Entity>&);
+
+        /*!
+        \brief Returns a View over the entities of a System whose entities
+        all own the components in the given mask. This is the same as
+        view(entities), except that if each of the entities is stored in the
+        tables of grouped components View::eachUnordered() walks the tables
+        directly, visiting the entities in table order rather than list order.
+        \see UseChunkedStorage
+        */
+        template <typename... Ts>
+        View<Ts...> view(const std::vector<Entity>&, const ComponentMask&);
+
+        /*!
+        \brief Writes every entity, and each component which can be
+        serialised, to the given Snapshot. Any existing data in the
+        snapshot is replaced.
+        \see ComponentSerialiser
+        */
+        void createSnapshot(Snapshot&) const;
+
+        /*!
+        \brief Appends to dst each living entity which would be destroyed,
+        or have its components changed, by restoring the given Snapshot.
+        This allows the entities to be removed from any systems before
+        their components are changed.
+        \returns false if the snapshot is invalid
+        */
+        bool getSnapshotChanges(const Snapshot&, std::vector<Entity>& dst) const;
+
+        /*!
+        \brief Restores the entities and components in the given Snapshot.
+        Components which can't be serialised are kept by any entity which
+        exists in both the snapshot and the manager, and removed from all
+        other entities. Pending component removals are cancelled, and no
+        messages are posted for entities which are destroyed.
+        \param dst Each restored entity which was created, or whose components
+        changed, is appended to this list so that it can be submitted to systems
+        \returns false if the snapshot is invalid, in which case nothing is changed
+        */
+        bool restoreSnapshot(const Snapshot&, std::vector<Entity>& dst);
+
     private:
         MessageBus& m_messageBus;
-        std::deque<Entity::ID> m_freeIDs;
-        std::vector<Entity::Generation> m_generations; // < indexed by entity ID
+        //indexed by entity ID. Slots in use hold the handle of their entity. Free slots
+        //hold the generation the slot will next be used with, and the index of the next
+        //free slot in place of their own, forming a FIFO list from m_freeHead to m_freeTail
+        std::vector<Entity::Handle> m_slots;
+        Entity::ID m_freeHead;
+        Entity::ID m_freeTail;
+        std::size_t m_freeCount;
+        std::size_t m_retiredCount;
         std::vector<std::unique_ptr<Detail::Pool>> m_componentPools; // < index is component ID. Pool index is entity ID.
+        std::vector<std::unique_ptr<Detail::PoolSerialiser>> m_serialisers; // < index is component ID. nullptr if the component can't be serialised
         std::vector<ComponentMask> m_componentMasks;
 
+        //tables of the components which use grouped storage. Entities are moved
+        //to the table for their component mask when they are submitted or changed
+        Detail::ArchetypeStorage m_archetypes;
+
+        //components marked for removal, and whether the entity has been submitted
+        //to systems or is already in the changed list, indexed by entity ID
+        std::vector<ComponentMask> m_removalMasks;
+        std::vector<sf::Uint8> m_entityFlags;
+        std::vector<Entity> m_changedEntities;
+
+        //per component type lists of entities whose components changed. Index is component ID
+        std::vector<std::unique_ptr<Detail::ChangeSet>> m_changeSets;
+        sf::Uint32 m_version;
+
+        void destroy(Entity);
+        void queueChanged(Entity::ID);
+        void releaseComponent(Entity::ID, Component::ID);
+        void resizeChangeSets();
+
+        //used by Prefab to construct grouped components directly in the
+        //table for its mask, if none of the entities have any components yet
+        void beginPlacement(const std::vector<Entity>&, const ComponentMask&);
+        void endPlacement(const std::vector<Entity>&);
+
+        bool readLayout(const Snapshot&, Detail::SnapshotLayout&) const;
+        void getSnapshotMasks(const Detail::SnapshotLayout&, std::vector<ComponentMask>&) const;
+
         template <typename T>
-        Detail::ComponentPool<T>& getPool();
+        Detail::PoolType<T>& getPool();
+
+        template <typename... Ts>
+        friend class View;
+        friend class Prefab;
     };
 
 #include "Entity.inl"
@@ -39,14 +39,12 @@ T& Entity::addComponent(Args&&... args)
     return m_entityManager->addComponent<T>(*this, std::forward<Args>(args)...);
 }
 
-//TODO this doesn't remove the entity from systems
-//which previously required the component being removed..
-//template <typename T>
-//void Entity::removeComponent()
-//{
-//    XY_ASSERT(m_entityManager, "Not a valid Entity");
-//    m_entityManager->removeComponent<T>(*this);
-//}
+template <typename T>
+void Entity::removeComponent()
+{
+    XY_ASSERT(m_entityManager, "Not a valid Entity");
+    m_entityManager->removeComponent<T>(*this);
+}
 
 template <typename T>
 bool Entity::hasComponent() const
@@ -66,5 +64,12 @@ template <typename T>
 const T& Entity::getComponent() const
 {
     XY_ASSERT(m_entityManager, "Not a valid Entity");
-    return m_entityManager->getComponent<T>(*this);
+    return static_cast<const EntityManager*>(m_entityManager)->getComponent<T>(*this);
+}
+
+template <typename T>
+void Entity::markChanged()
+{
+    XY_ASSERT(m_entityManager, "Not a valid Entity");
+    m_entityManager->markChanged<T>(*this);
 }
\ No newline at end of file
@@ -34,11 +34,20 @@ void EntityManager::addComponent(Entity entity, T component)
     auto& pool = getPool<T>();
     if (entID >= pool.size())
     {
-        pool.resize(m_generations.size());
+        pool.resize(m_slots.size());
     }
 
-    pool[entID] = std::move(component);
+    pool.insert(entID, std::move(component));
     m_componentMasks[entID].set(componentID);
+
+    //re-adding cancels any pending removal
+    m_removalMasks[entID].reset(componentID);
+    queueChanged(entID);
+
+    if (TrackChanges<T>::value)
+    {
+        markChanged(entity, componentID);
+    }
 }
 
 template <typename T, typename... Args>
@@ -49,17 +58,42 @@ T& EntityManager::addComponent(Entity entity, Args&&... args)
     return getComponent<T>(entity);
 }
 
-//TODO this doesn't remove the entity from active systems...
-//template <typename T>
-//void EntityManager::removeComponent(Entity entity)
-//{
-//    const auto componentID = Component::getID<T>();
-//    const auto entityID = entity.getIndex();
-//
-//    CRO_ASSERT(entityID < m_componentMasks.size(), "Entity index out of range");
-//    m_componentMasks[entityID].set(componentID, false);
-//    
-//}
+template <typename T>
+void EntityManager::addComponents(const std::vector<Entity>& entities, const T& component)
+{
+    const auto componentID = Component::getID<T>();
+
+    auto& pool = getPool<T>();
+    pool.prepare(m_slots.size(), entities.size());
+
+    for (auto entity : entities)
+    {
+        const auto entID = entity.getIndex();
+        pool.insertCopy(entID, component);
+        m_componentMasks[entID].set(componentID);
+        m_removalMasks[entID].reset(componentID);
+        queueChanged(entID);
+
+        if (TrackChanges<T>::value)
+        {
+            markChanged(entity, componentID);
+        }
+    }
+}
+
+template <typename T>
+void EntityManager::removeComponent(Entity entity)
+{
+    const auto componentID = Component::getID<T>();
+    const auto entityID = entity.getIndex();
+
+    XY_ASSERT(entityID < m_componentMasks.size(), "Entity index out of range");
+    if (m_componentMasks[entityID][componentID])
+    {
+        m_removalMasks[entityID].set(componentID);
+        queueChanged(entityID);
+    }
+}
 
 template <typename T>
 bool EntityManager::hasComponent(Entity entity) const
@@ -68,7 +102,7 @@ bool EntityManager::hasComponent(Entity entity) const
     const auto entityID = entity.getIndex();
 
     XY_ASSERT(entityID < m_componentMasks.size(), "Entity index out of range");
-    return m_componentMasks[entityID].test(componentID);
+    return m_componentMasks[entityID][componentID];
 }
 
 template <typename T>
@@ -78,24 +112,61 @@ T& EntityManager::getComponent(Entity entity)
     const auto entityID = entity.getIndex();
 
     XY_ASSERT(hasComponent<T>(entity), "Component does not exist!");
+#ifdef XY_DEBUG
+    Detail::checkComponentAccess(componentID);
+#endif
+
+    XY_ASSERT(componentID < m_componentPools.size(), "Component index out of range");
+    auto* pool = static_cast<Detail::PoolType<T>*>(m_componentPools[componentID].get());
 
+    XY_ASSERT(entityID < pool->size(), "Entity index out of range");
+
+    //mutable access is assumed to modify the component
+    if (TrackChanges<T>::value)
+    {
+        markChanged(entity, componentID);
+    }
+    return pool->at(entityID);
+}
+
+template <typename T>
+const T& EntityManager::getComponent(Entity entity) const
+{
+    const auto componentID = Component::getID<T>();
+    const auto entityID = entity.getIndex();
+
+    XY_ASSERT(hasComponent<T>(entity), "Component does not exist!");
+#ifdef XY_DEBUG
+    Detail::checkComponentAccess(componentID);
+#endif
 
     XY_ASSERT(componentID < m_componentPools.size(), "Component index out of range");
-    auto* pool = (dynamic_cast<Detail::ComponentPool<T>*>(m_componentPools[componentID].get()));
+    const auto* pool = static_cast<const Detail::PoolType<T>*>(m_componentPools[componentID].get());
 
     XY_ASSERT(entityID < pool->size(), "Entity index out of range");
     return pool->at(entityID);
 }
 
 template <typename T>
-Detail::ComponentPool<T>& EntityManager::getPool()
+void EntityManager::markChanged(Entity entity)
+{
+    XY_ASSERT(hasComponent<T>(entity), "Component does not exist!");
+    markChanged(entity, Component::getID<T>());
+}
+
+template <typename T>
+Detail::PoolType<T>& EntityManager::getPool()
 {
+    static_assert(!(UseSparseStorage<T>::value && UseChunkedStorage<T>::value), "Component storage must be either sparse or chunked, not both");
     const auto componentID = Component::getID<T>();
 
     if (!m_componentPools[componentID])
     {
-        m_componentPools[componentID] = std::make_unique<Detail::ComponentPool<T>>();
+        auto pool = std::make_unique<Detail::PoolType<T>>();
+        m_serialisers[componentID] = Detail::createSerialiser<T>(*pool, ComponentSerialiser<T>());
+        Detail::addGroupedPool(m_archetypes, componentID, *pool);
+        m_componentPools[componentID] = std::move(pool);
     }
 
-    return *(dynamic_cast<Detail::ComponentPool<T>*>(m_componentPools[componentID].get()));
+    return *(static_cast<Detail::PoolType<T>*>(m_componentPools[componentID].get()));
 }
\ No newline at end of file
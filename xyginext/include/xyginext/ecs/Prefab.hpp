@@ -0,0 +1,177 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_PREFAB_HPP_
+#define XY_PREFAB_HPP_
+
+#include <xyginext/Config.hpp>
+#include <xyginext/ecs/Entity.hpp>
+#include <xyginext/ecs/Component.hpp>
+#include <xyginext/core/ConfigFile.hpp>
+
+#include <vector>
+#include <memory>
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+namespace xy
+{
+    namespace Detail
+    {
+        /*!
+        \brief Type erased component stored in a Prefab
+        */
+        class ComponentPrototype
+        {
+        public:
+            virtual ~ComponentPrototype() = default;
+            virtual Component::ID getID() const = 0;
+            virtual void instantiate(EntityManager&, const std::vector<Entity>&) const = 0;
+        };
+
+        template <typename T>
+        class ComponentPrototypeImpl final : public ComponentPrototype
+        {
+        public:
+            explicit ComponentPrototypeImpl(T&& component) : m_component(std::move(component)) {}
+            Component::ID getID() const override { return Component::getID<T>(); }
+            void instantiate(EntityManager& em, const std::vector<Entity>& entities) const override
+            {
+                em.addComponents<T>(entities, m_component);
+            }
+            T& get() { return m_component; }
+
+        private:
+            T m_component;
+        };
+    }
+
+    /*!
+    \brief A set of components from which any number of entities can be created.
+    Prefabs can be built by adding components directly, captured from an existing
+    entity, or loaded from a ConfigFile. Use Scene::instantiate() to create entities
+    from a Prefab - all the entities are created in one go, each component pool is
+    resized once, and the new entities are submitted to systems together.
+    Components are duplicated with ComponentCopy so types such as Transform,
+    which can't be copy constructed, can still be used.
+    */
+    class XY_EXPORT_API Prefab final
+    {
+    public:
+        Prefab() = default;
+        ~Prefab() = default;
+        Prefab(const Prefab&) = delete;
+        Prefab& operator = (const Prefab&) = delete;
+        Prefab(Prefab&&) = default;
+        Prefab& operator = (Prefab&&) = default;
+
+        /*!
+        \brief Adds the given component to the prefab, replacing
+        any existing component of the same type.
+        \returns Reference to the prefab's component, which may be
+        used to modify it before instantiating.
+        */
+        template <typename T>
+        T& addComponent(T component);
+
+        /*!
+        \brief Returns true if the prefab contains a component of this type
+        */
+        template <typename T>
+        bool hasComponent() const;
+
+        /*!
+        \brief Returns a reference to the prefab's component of this type
+        */
+        template <typename T>
+        T& getComponent();
+
+        /*!
+        \brief Captures copies of the given component types from an
+        existing entity. Types which the entity doesn't have are skipped.
+        \code
+        prefab.capture<xy::Transform, xy::Sprite, xy::Drawable>(entity);
+        \endcode
+        */
+        template <typename... Ts>
+        void capture(Entity);
+
+        /*!
+        \brief Returns the mask of all the components in this prefab
+        */
+        const ComponentMask& getComponentMask() const { return m_componentMask; }
+
+        /*!
+        \brief Attempts to load the prefab from a ConfigFile.
+        Each object in the file is passed to the loader registered with
+        its name via registerComponent(). A loader for Transform is
+        registered by default with the name 'transform', which reads the
+        optional properties position, rotation, scale and origin.
+        \code
+        prefab crate
+        {
+            transform
+            {
+                position = 20,100
+                rotation = 45
+            }
+        }
+        \endcode
+        \returns false if the file couldn't be loaded
+        */
+        bool loadFromFile(const std::string& path);
+
+        /*!
+        \brief Registers a function used to create components of type T
+        from objects with the given name when loading a prefab from a file.
+        */
+        template <typename T>
+        static void registerComponent(const std::string& name, const std::function<T(const ConfigObject&)>& loader);
+
+        /*!
+        \brief Creates components for each of the given entities
+        */
+        void instantiate(EntityManager&, const std::vector<Entity>&) const;
+
+    private:
+        std::vector<std::unique_ptr<Detail::ComponentPrototype>> m_components;
+        ComponentMask m_componentMask;
+
+        using Loader = std::function<void(Prefab&, const ConfigObject&)>;
+        static std::unordered_map<std::string, Loader>& getLoaders();
+
+        void setPrototype(std::unique_ptr<Detail::ComponentPrototype>);
+
+        template <typename T>
+        Detail::ComponentPrototypeImpl<T>* findPrototype() const;
+    };
+
+#include "Prefab.inl"
+}
+
+#endif //XY_PREFAB_HPP_
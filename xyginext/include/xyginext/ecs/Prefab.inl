@@ -0,0 +1,79 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+template <typename T>
+T& Prefab::addComponent(T component)
+{
+    auto prototype = std::make_unique<Detail::ComponentPrototypeImpl<T>>(std::move(component));
+    auto& ret = prototype->get();
+    setPrototype(std::move(prototype));
+    return ret;
+}
+
+template <typename T>
+bool Prefab::hasComponent() const
+{
+    return m_componentMask[Component::getID<T>()];
+}
+
+template <typename T>
+T& Prefab::getComponent()
+{
+    auto* prototype = findPrototype<T>();
+    XY_ASSERT(prototype, "Component does not exist in prefab!");
+    return prototype->get();
+}
+
+template <typename... Ts>
+void Prefab::capture(Entity entity)
+{
+    using expand = int[];
+    (void)expand { 0, (entity.hasComponent<Ts>() ? (addComponent<Ts>(ComponentCopy<Ts>::copy(entity.getComponent<Ts>())), 0) : 0)... };
+}
+
+template <typename T>
+void Prefab::registerComponent(const std::string& name, const std::function<T(const ConfigObject&)>& loader)
+{
+    getLoaders()[name] = [loader](Prefab& prefab, const ConfigObject& obj)
+    {
+        prefab.addComponent<T>(loader(obj));
+    };
+}
+
+//private
+template <typename T>
+Detail::ComponentPrototypeImpl<T>* Prefab::findPrototype() const
+{
+    const auto id = Component::getID<T>();
+    auto result = std::find_if(m_components.begin(), m_components.end(),
+        [id](const std::unique_ptr<Detail::ComponentPrototype>& p)
+    {
+        return p->getID() == id;
+    });
+
+    return (result == m_components.end()) ? nullptr : static_cast<Detail::ComponentPrototypeImpl<T>*>(result->get());
+}
@@ -0,0 +1,182 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_ROLLBACK_HPP_
+#define XY_ROLLBACK_HPP_
+
+#include <xyginext/Config.hpp>
+#include <xyginext/ecs/Snapshot.hpp>
+
+#include <SFML/Config.hpp>
+
+#include <vector>
+#include <functional>
+#include <utility>
+
+namespace xy
+{
+    class Scene;
+
+    /*!
+    \brief Stores a history of Scene snapshots along with the input applied
+    during each tick, so that the Scene can be rolled back to an earlier tick
+    and resimulated up to the present. This allows a networked game to predict
+    the state of every player and physics object, then correct the prediction
+    once the real input or authoritative state for a past tick arrives.
+
+    Each update saveTick() should be called before Scene::update(), followed
+    by recordInput() for any input applied during that tick. Input for the
+    most recently saved tick is assumed not to have been simulated yet, input
+    recorded for any earlier tick which differs from what was previously
+    recorded marks the history from that tick as needing resimulation, which
+    is done with resimulateChanges(). State received from a server can be
+    applied to an earlier tick by passing a correction function to resimulate().
+    Resimulation should be done before saving the next tick.
+
+    While resimulating the Scene only processes systems which have declared
+    that they resimulate, and recorded input is applied by the input handler
+    rather than by the game's usual input path.
+    \see System::resimulates()
+    */
+    class XY_EXPORT_API Rollback final
+    {
+    public:
+        using Tick = sf::Uint32;
+
+        /*!
+        \brief Called once for each input recorded for a tick, before the tick
+        is resimulated. Receives the tick, the input source as passed to
+        recordInput() and the recorded input data.
+        */
+        using InputHandler = std::function<void(Tick, sf::Uint32, const std::vector<char>&)>;
+
+        /*!
+        \brief Constructor.
+        \param scene The Scene to roll back
+        \param tickCount The number of ticks of history to keep
+        */
+        explicit Rollback(Scene& scene, std::size_t tickCount = 60);
+
+        ~Rollback() = default;
+        Rollback(const Rollback&) = delete;
+        Rollback& operator = (const Rollback&) = delete;
+
+        /*!
+        \brief Sets the function used to apply recorded input when resimulating
+        */
+        void setInputHandler(const InputHandler& handler) { m_inputHandler = handler; }
+
+        /*!
+        \brief Takes a Snapshot of the Scene as the state at the start of the
+        given tick. Ticks are expected to be saved consecutively, saving any
+        other tick discards the existing history.
+        */
+        void saveTick(Tick);
+
+        /*!
+        \brief Records input from the given source, such as a player ID,
+        as having been applied during the given tick.
+        \returns false if the tick is no longer in the history
+        */
+        bool recordInput(Tick, sf::Uint32 source, const void* data, std::size_t size);
+
+        /*!
+        \brief Returns the input recorded from the given source for the given
+        tick, or nullptr if there is none
+        */
+        const std::vector<char>* getInput(Tick, sf::Uint32 source) const;
+
+        /*!
+        \brief Restores the Scene to the state at the start of the given tick
+        then resimulates each tick up to the present.
+        \param tick The tick to resimulate from
+        \param dt The time step to pass to Scene::resimulate()
+        \param correction Optional function called after the Scene has been
+        restored, which can modify the restored state, for example with the
+        authoritative state received from a server. The corrected state
+        replaces the state stored for the tick.
+        \returns false if the tick is not in the history, in which case the
+        Scene is not changed
+        */
+        bool resimulate(Tick tick, float dt, const std::function<void()>& correction = nullptr);
+
+        /*!
+        \brief Resimulates from the earliest tick whose recorded input has
+        changed since it was simulated, if there is one.
+        \returns true if the Scene was resimulated
+        */
+        bool resimulateChanges(float dt);
+
+        /*!
+        \brief Returns true if the state at the start of the given tick is stored
+        */
+        bool hasTick(Tick) const;
+
+        /*!
+        \brief Returns the most recently saved tick
+        */
+        Tick getLatestTick() const { return m_latestTick; }
+
+        /*!
+        \brief Returns the oldest tick still stored
+        */
+        Tick getOldestTick() const;
+
+        /*!
+        \brief Returns the number of ticks currently stored
+        */
+        std::size_t getTickCount() const { return m_tickCount; }
+
+        /*!
+        \brief Discards all stored ticks and input
+        */
+        void clear();
+
+    private:
+        struct TickState final
+        {
+            Tick tick = 0;
+            Snapshot snapshot;
+            std::vector<std::pair<sf::Uint32, std::vector<char>>> inputs;
+        };
+
+        Scene& m_scene;
+        std::vector<TickState> m_ticks;
+        std::size_t m_tickCount;
+        Tick m_latestTick;
+
+        bool m_changed;
+        Tick m_changedTick;
+
+        InputHandler m_inputHandler;
+
+        TickState& getState(Tick tick) { return m_ticks[tick % m_ticks.size()]; }
+        const TickState& getState(Tick tick) const { return m_ticks[tick % m_ticks.size()]; }
+    };
+}
+
+#endif //XY_ROLLBACK_HPP_
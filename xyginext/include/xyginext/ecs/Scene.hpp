@@ -32,6 +32,9 @@ source distribution.
 #include <xyginext/core/App.hpp>
 #include <xyginext/ecs/Entity.hpp>
 #include <xyginext/ecs/System.hpp>
+#include <xyginext/ecs/View.hpp>
+#include <xyginext/ecs/Prefab.hpp>
+#include <xyginext/ecs/Snapshot.hpp>
 #include <xyginext/ecs/systems/CommandSystem.hpp>
 #include <xyginext/ecs/Director.hpp>
 #include <xyginext/graphics/postprocess/PostProcess.hpp>
@@ -74,11 +77,38 @@ namespace xy
         */
         void update(float dt);
 
+        /*!
+        \brief Executes one simulation step again, usually after restoring
+        an earlier Snapshot. Pending entities are submitted and destroyed as
+        they would be by update(), but only systems which have declared that
+        they resimulate are processed. Directors and post processes are not
+        updated.
+        \see Rollback
+        */
+        void resimulate(float dt);
+
+        /*!
+        \brief Returns true while the Scene is being resimulated.
+        Systems which opt in to resimulation can use this to skip side
+        effects such as sounds or particles, which have already been
+        seen the first time the step was simulated.
+        */
+        bool isResimulating() const { return m_resimulating; }
+
         /*!
         \brief Creates a new entity in the Scene, and returns a copy of it
         */
         Entity createEntity();
 
+        /*!
+        \brief Creates the given number of entities from a Prefab.
+        All of the entities are created and have their components
+        added at once, and are submitted to systems together when
+        the Scene next updates.
+        \returns List of the newly created entities
+        */
+        std::vector<Entity> instantiate(const Prefab&, std::size_t count = 1);
+
         /*!
         \brief Destroys the given entity and removes it from the scene
         */
@@ -89,6 +119,36 @@ namespace xy
         */
         Entity getEntity(Entity::ID) const;
 
+        /*!
+        \brief Writes the state of every entity in the Scene to the given Snapshot.
+        Entities waiting to be destroyed are included, as they are not destroyed
+        until the Scene next updates.
+        \see Snapshot
+        */
+        void createSnapshot(Snapshot&) const;
+
+        /*!
+        \brief Restores the Scene's entities to the state in the given Snapshot.
+        Entities which are destroyed, or whose components change, are removed
+        from systems first, and restored entities are submitted to systems
+        straight away. Any entities queued for destruction since the snapshot
+        was taken are not destroyed. Entities which were destroyed since the
+        snapshot was taken are recreated with only the components contained in
+        the snapshot, so components which aren't serialised, such as Drawable
+        and Text, have to be added to them again before they are drawn.
+        \see ComponentSerialiser
+        \returns false if the snapshot is invalid, in which case nothing is changed
+        */
+        bool restoreSnapshot(const Snapshot&);
+
+        /*!
+        \brief Returns a View of all entities in the Scene which own
+        each of the given component types.
+        \see View
+        */
+        template <typename... Ts>
+        View<Ts...> view();
+
         /*!
         \brief Creates a new system of the given type.
         All systems need to be fully created before adding entities, else
@@ -188,11 +248,15 @@ namespace xy
 
         std::vector<Entity> m_pendingEntities;
         std::vector<Entity> m_destroyedEntities;
+        bool m_resimulating;
+        std::vector<sf::Uint32> m_transformQueue;
+        std::vector<Entity> m_movedEntities;
 
         EntityManager m_entityManager;
         SystemManager m_systemManager;
 
         std::vector<std::unique_ptr<Director>> m_directors;
+        Detail::MessageSubscribers<Director> m_directorSubscribers;
 
         std::vector<sf::Drawable*> m_drawables;
 
@@ -200,6 +264,9 @@ namespace xy
         std::array<sf::RenderTexture, 2u> m_postBuffers;
         std::vector<std::unique_ptr<PostProcess>> m_postEffects;
 
+        void updateEntities();
+        void updateTransforms();
+
         void postRenderPath(sf::RenderTarget&, sf::RenderStates);
         std::function<void(sf::RenderTarget&, sf::RenderStates)> currentRenderPath;
 
@@ -26,6 +26,12 @@ source distribution.
 *********************************************************************/
 
 
+template <typename... Ts>
+View<Ts...> Scene::view()
+{
+    return m_entityManager.view<Ts...>();
+}
+
 template <typename T, typename... Args>
 T& Scene::addSystem(Args&&... args)
 {
@@ -64,6 +70,9 @@ void Scene::addDirector(Args&&... args)
     m_directors.back()->m_commandSystem = &m_systemManager.getSystem<CommandSystem>();
     m_directors.back()->m_messageBus = &m_messageBus;
     m_directors.back()->m_scene = this;
+
+    auto* director = m_directors.back().get();
+    m_directorSubscribers.add(director, director->m_subscriptions, director->m_subscribesAll);
 }
 
 template <typename T, typename... Args>
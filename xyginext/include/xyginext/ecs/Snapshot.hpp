@@ -0,0 +1,136 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_SNAPSHOT_HPP_
+#define XY_SNAPSHOT_HPP_
+
+#include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
+
+#include <SFML/Config.hpp>
+
+#include <vector>
+#include <string>
+
+namespace xy
+{
+    namespace Detail
+    {
+        /*!
+        \brief Snapshot data starts with this header, followed by the entity
+        handles, then a block for each component pool containing the component
+        name, the indices of the entities which own the component, and the
+        serialised components themselves.
+        */
+        struct SnapshotHeader final
+        {
+            static constexpr sf::Uint32 Magic = 0x53535958; //'XYSS'
+            static constexpr sf::Uint32 CurrentVersion = 1;
+
+            sf::Uint32 magic = 0;
+            sf::Uint32 version = 0;
+            sf::Uint32 handleSize = 0;
+            sf::Uint32 slotCount = 0;
+            sf::Uint32 freeHead = 0;
+            sf::Uint32 freeTail = 0;
+            sf::Uint32 poolCount = 0;
+            sf::Uint32 padding = 0;
+            sf::Uint64 freeCount = 0;
+            sf::Uint64 retiredCount = 0;
+        };
+    }
+
+    /*!
+    \brief A binary copy of the state of a Scene's entities.
+    Snapshots contain every entity handle, component mask and each
+    component which can be serialised. Component types are included by
+    specialising ComponentSerialiser, as Transform and Sprite do, and
+    those which hold only plain values may be copied byte for byte with
+    ByteSerialiser. Other components, such as Drawable and Text, are not
+    included. Entities which the snapshot recreates have only the
+    components it contains, and those components are restored without
+    the resources they refer to, such as a Sprite's texture, which must
+    be set again by the application. Snapshots are taken
+    with Scene::createSnapshot() and applied with Scene::restoreSnapshot(),
+    and are intended to be cheap enough to take every update, for example
+    to roll back and resimulate a networked game. The same Snapshot can be
+    reused each time to avoid reallocating its buffer.
+    Component types are identified by their type name, so a snapshot can
+    only be restored by a build of the same application, in which each of
+    the snapshot's component types has already been used by the Scene.
+    \see ComponentSerialiser
+    */
+    class XY_EXPORT_API Snapshot final
+    {
+    public:
+        /*!
+        \brief Returns the raw snapshot data
+        */
+        const std::vector<char>& getData() const { return m_data; }
+
+        /*!
+        \brief Replaces the snapshot with a copy of the given data,
+        for instance one received over the network.
+        \returns false if the data is not a valid snapshot
+        */
+        bool setData(const char* data, std::size_t size);
+
+        /*!
+        \brief Returns the size of the snapshot in bytes
+        */
+        std::size_t size() const { return m_data.size(); }
+
+        /*!
+        \brief Returns true if the snapshot contains a valid header
+        for this build of xygine
+        */
+        bool isValid() const;
+
+        /*!
+        \brief Writes the snapshot to a binary file
+        \returns true on success
+        */
+        bool saveToFile(const std::string& path) const;
+
+        /*!
+        \brief Loads a snapshot from a file previously written with saveToFile()
+        \returns true on success
+        */
+        bool loadFromFile(const std::string& path);
+
+    private:
+        std::vector<char> m_data;
+
+        //component types whose data has been read successfully by this build.
+        //Cleared when the data is replaced from outside
+        mutable ComponentMask m_verified;
+
+        friend class EntityManager;
+    };
+}
+
+#endif //XY_SNAPSHOT_HPP_
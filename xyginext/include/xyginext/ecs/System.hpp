@@ -31,10 +31,15 @@ source distribution.
 #include <xyginext/Config.hpp>
 #include <xyginext/ecs/Entity.hpp>
 #include <xyginext/ecs/Component.hpp>
+#include <xyginext/ecs/View.hpp>
 #include <xyginext/core/MessageBus.hpp>
+#include <xyginext/core/JobSystem.hpp>
+#include <xyginext/detail/MessageSubscribers.hpp>
 
 #include <vector>
 #include <typeindex>
+#include <algorithm>
+#include <unordered_map>
 
 namespace xy
 {
@@ -47,6 +52,12 @@ namespace xy
     Systems should all derive from this base class, and instanciated before any entities
     are created. Concrete system types should declare a list component types via requireComponent()
     on construction, so that only entities with the relevant components are added to the system.
+
+    Systems may also declare which components they read and write during process()
+    with readsComponent() and writesComponent(). The SystemManager runs systems whose
+    declared access doesn't conflict at the same time, on the JobSystem. Systems which
+    declare nothing are assumed to access everything, and are run on their own on the
+    thread which updates the Scene.
     */
     class XY_EXPORT_API System
     {
@@ -61,7 +72,8 @@ namespace xy
         */
         //template <typename T>
         System(MessageBus& mb, UniqueType t) 
-            : m_messageBus(mb), m_type(t), m_scene(nullptr), m_active(false){}
+            : m_messageBus(mb), m_type(t), m_accessDeclared(false), m_postsMessages(false), m_resimulates(false),
+            m_subscribesAll(false), m_processing(false), m_lastVersion(0), m_scene(nullptr), m_entityManager(nullptr), m_active(false){}
 
         virtual ~System() = default;
 
@@ -81,10 +93,24 @@ namespace xy
         void addEntity(Entity);
 
         /*!
-        \brief Removes an entity from the list to process
+        \brief Removes an entity from the list to process.
+        This is O(1) but does not preserve the order of the entity list,
+        the last entity in the list is moved in to the removed entity's place.
         */
         void removeEntity(Entity);
 
+        /*!
+        \brief Removes all of the given entities which belong to this
+        system, compacting the entity list once. The order of the
+        remaining entities is preserved.
+        */
+        void removeEntities(const std::vector<Entity>&);
+
+        /*!
+        \brief Returns true if the given entity is currently in this system
+        */
+        bool hasEntity(Entity) const;
+
         /*!
         \brief Returns the component mask used to mask entities with corresponding
         components for this system to process
@@ -92,7 +118,46 @@ namespace xy
         const ComponentMask& getComponentMask() const;
 
         /*!
-        \brief Used to process any incoming system messages
+        \brief Returns the mask of components this system reads during process().
+        This includes all required components.
+        */
+        const ComponentMask& getReadMask() const { return m_readMask; }
+
+        /*!
+        \brief Returns the mask of components this system writes during process()
+        */
+        const ComponentMask& getWriteMask() const { return m_writeMask; }
+
+        /*!
+        \brief Returns true if this system has declared its component access
+        with readsComponent() or writesComponent(), and so may be run
+        concurrently with other systems.
+        */
+        bool declaresAccess() const { return m_accessDeclared; }
+
+        /*!
+        \brief Returns true if this system has declared that it posts messages
+        */
+        bool canPostMessages() const { return m_postsMessages; }
+
+        /*!
+        \brief Returns true if this system has declared that it is
+        processed when the Scene is resimulated
+        \see Scene::resimulate()
+        */
+        bool canResimulate() const { return m_resimulates; }
+
+        /*!
+        \brief Returns true if the given system may be processed at the same
+        time as this one, based on the access declared by both.
+        */
+        bool canRunWith(const System&) const;
+
+        /*!
+        \brief Used to process any incoming system messages.
+        Only messages with an ID to which the system has subscribed
+        are passed to this function.
+        \see subscribe()
         */
         virtual void handleMessage(const Message&);
 
@@ -116,8 +181,104 @@ namespace xy
         template <typename T>
         void requireComponent();
 
+        /*!
+        \brief Declares that process() reads components of this type.
+        Required components are automatically declared as read.
+        */
+        template <typename T>
+        void readsComponent();
+
+        /*!
+        \brief Declares that process() writes to components of this type.
+        Two systems which write to the same component type, or where one
+        writes a component type the other reads, are processed in the
+        order in which they were added to the scene.
+        */
+        template <typename T>
+        void writesComponent();
+
+        /*!
+        \brief Declares that process() posts messages on the MessageBus.
+        Systems which post messages are always processed on the thread
+        which updates the Scene, and never at the same time as any other
+        system, so the order of their messages is deterministic. Systems which
+        create or destroy entities, or add components, must not declare
+        their access at all so that they are processed on their own.
+        */
+        void postsMessages() { m_postsMessages = true; m_accessDeclared = true; }
+
+        /*!
+        \brief Declares that this system is processed when the Scene is
+        resimulated, for example by a Rollback. Only systems which update
+        the simulation deterministically from the components stored in a
+        Snapshot, such as movement or collision, should opt in. Rendering,
+        audio and other presentation systems are skipped during resimulation.
+        \see Scene::isResimulating()
+        */
+        void resimulates() { m_resimulates = true; }
+
+        /*!
+        \brief Subscribes the system to messages with the given ID, so that
+        they are passed to handleMessage(). Subscriptions must be made in the
+        system's constructor.
+        */
+        void subscribe(Message::ID);
+
+        /*!
+        \brief Subscribes the system to every message posted on the MessageBus.
+        Prefer subscribing to specific message IDs, so that the system isn't
+        called for messages which it ignores.
+        */
+        void subscribeAll();
+
+        /*!
+        \brief Returns the list of entities processed by this system.
+        Prefer sortEntities() to reordering this list directly, as the
+        system then has to rebuild its record of each entity's position.
+        */
         std::vector<Entity>& getEntities() { return m_entities; }
 
+        /*!
+        \brief Sorts the system's entity list using the given comparison,
+        which has the same requirements as that of std::sort()
+        */
+        template <typename Compare>
+        void sortEntities(Compare compare);
+
+        /*!
+        \brief Returns a View over this system's entities.
+        Use this to iterate the system's entities with the component
+        pools resolved up front, rather than calling getComponent()
+        on each entity. Only component types required by the system
+        should be requested. Entities are visited in the same order as
+        getEntities(), such as after sortEntities(), unless the view is
+        iterated with View::eachUnordered().
+        \see View
+        */
+        template <typename... Ts>
+        View<Ts...> view();
+
+        /*!
+        \brief Returns a View over the given list of entities, which must
+        all belong to this system, such as the list returned by getChanged()
+        */
+        template <typename... Ts>
+        View<Ts...> view(const std::vector<Entity>&);
+
+        /*!
+        \brief Returns the entities in this system whose component of the
+        given type has been marked as changed since this system was last
+        processed. Entities may be reported by two consecutive calls to
+        process(), if they were changed in the same version in which this
+        system was last processed. If the system was not processed in the
+        previous update, such as when it was inactive, all of its entities
+        are returned. The returned list is only valid until the next call
+        to getChanged().
+        \see TrackChanges
+        */
+        template <typename T>
+        const std::vector<Entity>& getChanged();
+
         /*!
         \brief Optional callback performed when an entity is added
         */
@@ -155,9 +316,24 @@ namespace xy
         UniqueType m_type;
 
         ComponentMask m_componentMask;
+        ComponentMask m_readMask;
+        ComponentMask m_writeMask;
+        bool m_accessDeclared;
+        bool m_postsMessages;
+        bool m_resimulates;
+        bool m_subscribesAll;
+        std::vector<Message::ID> m_subscriptions;
+        bool m_processing; //set by the system manager during process() so access can be validated
         std::vector<Entity> m_entities;
+        mutable std::vector<std::uint32_t> m_entitySlots; //index into m_entities, indexed by entity index
+        void rebuildSlots() const;
+
+        std::vector<Entity> m_changed;
+        sf::Uint32 m_lastVersion; //change tracking version when the system was last processed
+        const std::vector<Entity>& getChanged(Component::ID);
 
         Scene* m_scene;
+        EntityManager* m_entityManager;
 
         bool m_active; //used by system manager to check if it has been added to the active list
         friend class SystemManager;
@@ -166,7 +342,7 @@ namespace xy
     class XY_EXPORT_API SystemManager final
     {
     public:
-        explicit SystemManager(Scene&);
+        SystemManager(Scene&, EntityManager&);
 
         ~SystemManager() = default;
         SystemManager(const SystemManager&) = delete;
@@ -211,31 +387,94 @@ namespace xy
         bool hasSystem() const;
 
         /*!
-        \brief Submits an entity to all available systems
+        \brief Submits an entity to all available systems.
+        The list of systems matching each unique component mask is cached,
+        so entities with the same set of components only pay for a single
+        lookup.
         */
         void addToSystems(Entity);
 
+        /*!
+        \brief Submits a list of entities to all available systems.
+        Consecutive entities with the same component mask, such as
+        those created from a Prefab, share a single lookup.
+        */
+        void addToSystems(const std::vector<Entity>&);
+
         /*!
         \brief Removes the given Entity from any systems to which it may belong
         */
         void removeFromSystems(Entity);
 
+        /*!
+        \brief Removes all the given entities from any systems to which they may belong.
+        Each system's entity list is compacted only once, so this is preferable
+        when removing many entities at the same time.
+        */
+        void removeFromSystems(const std::vector<Entity>&);
+
+        /*!
+        \brief Updates which systems the given entity belongs to
+        based on the given component mask, adding it to systems
+        it now matches and removing it from those it no longer does.
+        */
+        void updateSystems(Entity, const ComponentMask&);
+
         /*!
         \brief Forwards messages to all systems
         */
         void forwardMessage(const Message&);
 
         /*!
-        \brief Runs a simulation step by calling process() on each system
+        \brief Runs a simulation step by calling process() on each system.
+        Consecutive systems which declare their component access may be
+        processed concurrently on the JobSystem. Systems which don't declare
+        their access, or which post messages, are processed on the calling
+        thread once the systems added before them have completed, so that
+        messages are always posted in the order in which systems were added. In debug builds any component accessed
+        by a system which is not in its declared access will raise an
+        assertion.
         */
         void process(float);
+
+        /*!
+        \brief Processes only the active systems which have declared that
+        they resimulate, in the order in which they were added.
+        \see System::resimulates()
+        */
+        void resimulate(float);
     private:
         Scene& m_scene;
+        EntityManager& m_entityManager;
         std::vector<std::unique_ptr<System>> m_systems;
         std::vector<System*> m_activeSystems;
 
+        //active systems in the order they are processed. Consecutive systems which
+        //declare their access share a stage, with a task graph built from that access.
+        //Rebuilt when the active list changes
+        struct Stage final
+        {
+            std::vector<System*> systems;
+            TaskGraph taskGraph;
+        };
+        std::vector<Stage> m_stages;
+        bool m_graphDirty;
+        float m_frameTime;
+
+        void buildGraph();
+        static void processSystem(System&, float);
+
+        //systems which match a given entity mask. Cleared when systems are added or removed
+        std::unordered_map<ComponentMask, std::vector<System*>> m_maskCache;
+
         template <typename T>
         void removeFromActive();
+
+        const std::vector<System*>& getMatchingSystems(const ComponentMask&);
+
+        //systems subscribed to each message ID. Rebuilt when a system is removed
+        Detail::MessageSubscribers<System> m_subscribers;
+        void updateSubscribers();
     };
 
 #include "System.inl"
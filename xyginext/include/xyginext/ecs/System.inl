@@ -30,10 +30,69 @@ void System::requireComponent()
 {
     const auto id = Component::getID<T>();
     m_componentMask.set(id);
+    m_readMask.set(id);
+}
+
+template <typename T>
+void System::readsComponent()
+{
+    m_readMask.set(Component::getID<T>());
+    m_accessDeclared = true;
+}
+
+template <typename T>
+void System::writesComponent()
+{
+    m_writeMask.set(Component::getID<T>());
+    m_accessDeclared = true;
+}
+
+template <typename... Ts>
+View<Ts...> System::view()
+{
+    XY_ASSERT(m_entityManager, "System has not been added to a Scene");
+#ifdef XY_DEBUG
+    ComponentMask mask;
+    using expand = int[];
+    (void)expand { 0, (mask.set(Component::getID<Ts>()), 0)... };
+    XY_ASSERT((m_componentMask & mask) == mask, "View requests components not required by this system");
+#endif
+    //an empty list may mean the pools don't exist yet, and creating
+    //them here would race with other systems running concurrently
+    if (m_entities.empty())
+    {
+        return {};
+    }
+    return m_entityManager->view<Ts...>(m_entities, m_componentMask);
+}
+
+template <typename Compare>
+void System::sortEntities(Compare compare)
+{
+    std::sort(m_entities.begin(), m_entities.end(), compare);
+    rebuildSlots();
+}
+
+template <typename... Ts>
+View<Ts...> System::view(const std::vector<Entity>& entities)
+{
+    XY_ASSERT(m_entityManager, "System has not been added to a Scene");
+    if (entities.empty())
+    {
+        return {};
+    }
+    return m_entityManager->view<Ts...>(entities);
+}
+
+template <typename T>
+const std::vector<Entity>& System::getChanged()
+{
+    return getChanged(Component::getID<T>());
 }
 
 template <typename T>
 T* System::postMessage(Message::ID id)
 {
+    XY_ASSERT(!m_processing || !m_accessDeclared || m_postsMessages, "System posts messages without declaring postsMessages()");
     return m_messageBus.post<T>(id);
 }
\ No newline at end of file
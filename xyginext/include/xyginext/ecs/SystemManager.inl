@@ -42,10 +42,16 @@ T& SystemManager::addSystem(Args&&... args)
         return *(dynamic_cast<T*>(result->get()));
     }
 
+    m_maskCache.clear();
     m_systems.emplace_back(std::make_unique<T>(std::forward<Args>(args)...));
     m_systems.back()->setScene(m_scene);
+    m_systems.back()->m_entityManager = &m_entityManager;
     m_activeSystems.push_back(m_systems.back().get());
     m_systems.back()->m_active = true;
+    m_graphDirty = true;
+
+    auto* system = m_systems.back().get();
+    m_subscribers.add(system, system->m_subscriptions, system->m_subscribesAll);
 
     return *(dynamic_cast<T*>(m_systems.back().get()));
 }
@@ -53,6 +59,11 @@ T& SystemManager::addSystem(Args&&... args)
 template <typename T>
 void SystemManager::removeSystem()
 {
+    m_maskCache.clear();
+
+    //the active list is checked first, while the system still exists
+    removeFromActive<T>();
+
     UniqueType type(typeid(T));
     m_systems.erase(std::remove_if(std::begin(m_systems), std::end(m_systems),
         [&type](const System::Ptr& sys) 
@@ -60,7 +71,7 @@ void SystemManager::removeSystem()
         return sys->getType() == type;
     }), std::end(m_systems));
 
-    removeFromActive<T>();
+    updateSubscribers();
 }
 
 template <typename T>
@@ -88,6 +99,7 @@ void SystemManager::setSystemActive(bool active)
             {
                 m_activeSystems.push_back((*result).get());
                 (*result)->m_active = true;
+                m_graphDirty = true;
             }
         }
     }
@@ -131,4 +143,5 @@ void SystemManager::removeFromActive()
     {
         return sys->getType() == type;
     }), std::end(m_activeSystems));
+    m_graphDirty = true;
 }
\ No newline at end of file
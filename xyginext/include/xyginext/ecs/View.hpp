@@ -0,0 +1,228 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_VIEW_HPP_
+#define XY_VIEW_HPP_
+
+#include <xyginext/ecs/Entity.hpp>
+
+#include <tuple>
+#include <vector>
+#include <algorithm>
+
+namespace xy
+{
+    namespace Detail
+    {
+        //used to find the smallest sparse pool when creating a view
+        template <typename T>
+        void smallestIndices(SparsePool<T>& pool, const std::vector<std::uint32_t>*& current)
+        {
+            if (!current || pool.getIndices().size() < current->size())
+            {
+                current = &pool.getIndices();
+            }
+        }
+
+        template <typename P>
+        void smallestIndices(P&, const std::vector<std::uint32_t>*&) {}
+
+        //used when walking ArchetypeTables. Grouped components are read
+        //from the table's columns a chunk at a time, others from their pool.
+        template <typename T, bool Grouped = UseChunkedStorage<T>::value>
+        struct TableAccess final
+        {
+            T* chunk = nullptr;
+
+            void setChunk(const ArchetypeTable& table, std::size_t index)
+            {
+                chunk = table.getColumn<T>().getChunk(index);
+            }
+
+            T& get(PoolType<T>&, std::size_t row, std::uint32_t) const { return chunk[row]; }
+        };
+
+        template <typename T>
+        struct TableAccess<T, false> final
+        {
+            void setChunk(const ArchetypeTable&, std::size_t) {}
+
+            T& get(PoolType<T>& pool, std::size_t, std::uint32_t entity) const { return pool.at(entity); }
+        };
+    }
+
+    /*!
+    \brief A typed view of the entities which own all of the given
+    component types.
+    Views resolve the component pools once on creation, so iterating
+    a view avoids the per-entity ID lookup and pool indirection paid
+    by Entity::getComponent(). A view created from a System's entity
+    list skips the component mask check entirely as the System already
+    guarantees each entity has the required components. A view created
+    by the Scene walks the smallest sparse pool if any of the components
+    are sparse, else every entity index, checking masks as it goes.
+    When any of the components use grouped storage, and every matching
+    entity is already in a table, views created by the Scene instead
+    walk the matching ArchetypeTables row by row, reading grouped
+    components linearly from each table's columns. Views of an entity
+    list always visit entities in list order, unless eachUnordered()
+    is used to allow walking the tables in their place.
+    Views are lightweight and should be created on the fly each time
+    they are needed, rather than stored, as they reference pools and
+    lists which may change between frames.
+    \code
+    for (auto components : scene.view<Transform, Drawable>())
+    {
+        auto& tx = std::get<0>(components);
+        auto& drawable = std::get<1>(components);
+    }
+
+    //or with the entity
+    scene.view<Transform, Drawable>().each([](Entity e, Transform& tx, Drawable& drawable) {});
+    \endcode
+    */
+    template <typename... Ts>
+    class View final
+    {
+    public:
+        /*!
+        \brief Constructs an empty view
+        */
+        View();
+
+        /*!
+        \brief Iterator type which yields a tuple of component references
+        */
+        class Iterator final
+        {
+        public:
+            Iterator(const View* view, std::size_t position) : m_view(view), m_position(position) { skip(); }
+
+            Iterator& operator ++ () { ++m_position; skip(); return *this; }
+            bool operator == (const Iterator& other) const { return m_position == other.m_position; }
+            bool operator != (const Iterator& other) const { return m_position != other.m_position; }
+
+            std::tuple<Ts&...> operator * () const { return m_view->getComponents(m_view->getIndex(m_position)); }
+
+            /*!
+            \brief Returns the entity at the iterator's current position
+            */
+            Entity getEntity() const { return m_view->getEntity(m_position); }
+
+        private:
+            const View* m_view;
+            std::size_t m_position;
+
+            void skip()
+            {
+                while (m_position < m_view->m_count && !m_view->matches(m_position))
+                {
+                    ++m_position;
+                }
+            }
+        };
+
+        Iterator begin() const { return Iterator(this, 0); }
+        Iterator end() const { return Iterator(this, m_count); }
+
+        /*!
+        \brief Calls the given function with each matching entity and
+        references to its components.
+        \param func A callable with the signature void(Entity, Ts&...)
+        */
+        template <typename Func>
+        void each(Func&& func) const;
+
+        /*!
+        \brief Calls the given function with each matching entity, as each()
+        does, but in whichever order is quickest. If the view is of an entity
+        list, such as that of a System, and every entity in it is stored in
+        the tables of grouped components, the tables are walked in place of
+        the list. Use this where the order in which entities are visited
+        doesn't matter.
+        \param func A callable with the signature void(Entity, Ts&...)
+        \see UseChunkedStorage
+        */
+        template <typename Func>
+        void eachUnordered(Func&& func) const;
+
+        /*!
+        \brief Returns the number of candidate entities in the view.
+        When the view has to check component masks this is an upper
+        bound on the number of entities actually visited.
+        */
+        std::size_t size() const { return m_count; }
+
+        /*!
+        \brief Returns the components of the entity at the given position.
+        This is only valid for views created from a list of entities, where
+        every position is known to match, and allows splitting the view
+        across threads with JobSystem::parallelFor()
+        */
+        std::tuple<Ts&...> operator [] (std::size_t position) const
+        {
+            XY_ASSERT(!m_checkMask && position < m_count, "Invalid view position");
+            return getComponents(getIndex(position));
+        }
+
+    private:
+        enum class Source
+        {
+            List, Indices, All, Tables
+        }m_source;
+
+        EntityManager* m_entityManager;
+        std::tuple<Detail::PoolType<Ts>*...> m_pools;
+
+        const std::vector<Entity>* m_entities;
+        const std::vector<std::uint32_t>* m_indices;
+        std::size_t m_count;
+
+        std::vector<const Detail::ArchetypeTable*> m_tables;
+        std::vector<std::size_t> m_offsets; //< position of the first row of each table
+
+        ComponentMask m_mask;
+        ComponentMask m_listMask; //< components owned by every entity in the list, used to find their tables
+        bool m_checkMask;
+
+        std::size_t getIndex(std::size_t position) const;
+        Entity getEntity(std::size_t position) const;
+        bool matches(std::size_t position) const;
+        std::tuple<Ts&...> getComponents(std::size_t index) const;
+
+        template <typename Func>
+        void eachTable(const std::vector<const Detail::ArchetypeTable*>&, Func&& func) const;
+
+        void setTables(std::vector<const Detail::ArchetypeTable*>&&);
+
+        friend class EntityManager;
+    };
+
+#include "View.inl"
+}
+
+#endif //XY_VIEW_HPP_
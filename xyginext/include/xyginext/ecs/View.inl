@@ -0,0 +1,239 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+template <typename... Ts>
+View<Ts...>::View()
+    : m_source      (Source::List),
+    m_entityManager (nullptr),
+    m_pools         (),
+    m_entities      (nullptr),
+    m_indices       (nullptr),
+    m_count         (0),
+    m_checkMask     (false)
+{
+
+}
+
+template <typename... Ts>
+template <typename Func>
+void View<Ts...>::each(Func&& func) const
+{
+    if (m_source == Source::Tables)
+    {
+        eachTable(m_tables, std::forward<Func>(func));
+        return;
+    }
+
+    for (auto i = 0u; i < m_count; ++i)
+    {
+        if (matches(i))
+        {
+            const auto index = getIndex(i);
+            func(getEntity(i), std::get<Detail::PoolType<Ts>*>(m_pools)->at(index)...);
+        }
+    }
+}
+
+template <typename... Ts>
+template <typename Func>
+void View<Ts...>::eachUnordered(Func&& func) const
+{
+    //the entity list is a subset of the table rows matching its mask,
+    //so if the counts are the same they contain the same entities
+    if (m_source == Source::List && m_listMask.any()
+        && (m_listMask & m_entityManager->m_archetypes.getGroupedMask()).any()
+        && !m_entityManager->m_archetypes.hasStaged(m_listMask))
+    {
+        std::vector<const Detail::ArchetypeTable*> tables;
+        if (m_entityManager->m_archetypes.getTables(m_listMask, tables) == m_count)
+        {
+            eachTable(tables, std::forward<Func>(func));
+            return;
+        }
+    }
+    each(std::forward<Func>(func));
+}
+
+//private
+template <typename... Ts>
+std::size_t View<Ts...>::getIndex(std::size_t position) const
+{
+    switch (m_source)
+    {
+    default:
+    case Source::List:
+        return (*m_entities)[position].getIndex();
+    case Source::Indices:
+        return (*m_indices)[position];
+    case Source::All:
+        return position;
+    case Source::Tables:
+    {
+        const auto table = std::distance(m_offsets.begin(), std::upper_bound(m_offsets.begin(), m_offsets.end(), position)) - 1;
+        return m_tables[table]->getEntities()[position - m_offsets[table]];
+    }
+    }
+}
+
+template <typename... Ts>
+Entity View<Ts...>::getEntity(std::size_t position) const
+{
+    if (m_source == Source::List)
+    {
+        return (*m_entities)[position];
+    }
+    return m_entityManager->getEntity(static_cast<Entity::ID>(getIndex(position)));
+}
+
+template <typename... Ts>
+bool View<Ts...>::matches(std::size_t position) const
+{
+    return !m_checkMask
+        || (m_entityManager->m_componentMasks[getIndex(position)] & m_mask) == m_mask;
+}
+
+template <typename... Ts>
+std::tuple<Ts&...> View<Ts...>::getComponents(std::size_t index) const
+{
+    return std::tuple<Ts&...>(std::get<Detail::PoolType<Ts>*>(m_pools)->at(index)...);
+}
+
+template <typename... Ts>
+template <typename Func>
+void View<Ts...>::eachTable(const std::vector<const Detail::ArchetypeTable*>& tables, Func&& func) const
+{
+    const std::size_t chunkSize = Detail::ArchetypeColumn::ChunkSize;
+    std::tuple<Detail::TableAccess<Ts>...> access;
+    for (const auto* table : tables)
+    {
+        const auto& entities = table->getEntities();
+        for (auto first = 0u, chunk = 0u; first < entities.size(); first += chunkSize, ++chunk)
+        {
+            using expand = int[];
+            (void)expand { 0, (std::get<Detail::TableAccess<Ts>>(access).setChunk(*table, chunk), 0)... };
+
+            const auto count = std::min(entities.size() - first, chunkSize);
+            for (auto row = 0u; row < count; ++row)
+            {
+                const auto index = entities[first + row];
+                func(m_entityManager->getEntity(index),
+                    std::get<Detail::TableAccess<Ts>>(access).get(*std::get<Detail::PoolType<Ts>*>(m_pools), row, index)...);
+            }
+        }
+    }
+}
+
+template <typename... Ts>
+void View<Ts...>::setTables(std::vector<const Detail::ArchetypeTable*>&& tables)
+{
+    m_source = Source::Tables;
+    m_tables = std::move(tables);
+    m_offsets.clear();
+    m_count = 0;
+    for (const auto* table : m_tables)
+    {
+        m_offsets.push_back(m_count);
+        m_count += table->size();
+    }
+    m_checkMask = false;
+}
+
+//implemented here rather than in EntityManager.inl as View must be complete
+template <typename... Ts>
+View<Ts...> EntityManager::view()
+{
+#ifdef XY_DEBUG
+    using check = int[];
+    (void)check { 0, (Detail::checkComponentAccess(Component::getID<Ts>()), 0)... };
+#endif
+    View<Ts...> view;
+    view.m_entityManager = this;
+    view.m_pools = std::make_tuple(&getPool<Ts>()...);
+
+    using expand = int[];
+    (void)expand { 0, (view.m_mask.set(Component::getID<Ts>()), 0)... };
+
+    //if any of the components are sparse walk the smallest set
+    const std::vector<std::uint32_t>* indices = nullptr;
+    (void)expand { 0, (Detail::smallestIndices(getPool<Ts>(), indices), 0)... };
+
+    //if any components are grouped and all of them are in
+    //tables walk the tables, unless a sparse set is smaller
+    if ((view.m_mask & m_archetypes.getGroupedMask()).any()
+        && !m_archetypes.hasStaged(view.m_mask))
+    {
+        std::vector<const Detail::ArchetypeTable*> tables;
+        const auto count = m_archetypes.getTables(view.m_mask, tables);
+        if (!indices || count <= indices->size())
+        {
+            view.setTables(std::move(tables));
+            return view;
+        }
+    }
+
+    if (indices)
+    {
+        view.m_source = View<Ts...>::Source::Indices;
+        view.m_indices = indices;
+        view.m_count = indices->size();
+        view.m_checkMask = (sizeof...(Ts) > 1);
+    }
+    else
+    {
+        view.m_source = View<Ts...>::Source::All;
+        view.m_count = m_slots.size();
+        view.m_checkMask = true;
+    }
+
+    return view;
+}
+
+template <typename... Ts>
+View<Ts...> EntityManager::view(const std::vector<Entity>& entities)
+{
+    View<Ts...> view;
+    view.m_entityManager = this;
+    view.m_pools = std::make_tuple(&getPool<Ts>()...);
+
+    using expand = int[];
+    (void)expand { 0, (view.m_mask.set(Component::getID<Ts>()), 0)... };
+
+    view.m_source = View<Ts...>::Source::List;
+    view.m_entities = &entities;
+    view.m_count = entities.size();
+    view.m_checkMask = false;
+
+    return view;
+}
+
+template <typename... Ts>
+View<Ts...> EntityManager::view(const std::vector<Entity>& entities, const ComponentMask& mask)
+{
+    auto view = this->view<Ts...>(entities);
+    view.m_listMask = mask | view.m_mask;
+    return view;
+}
@@ -29,6 +29,7 @@ source distribution.
 #define XY_AUDIO_LISTENER_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <algorithm>
 
@@ -69,6 +70,12 @@ namespace xy
         friend class AudioSystem;
         float m_volume = 1.f;
     };
+
+    /*!
+    \brief The listener only holds its volume, so is copied byte for byte in snapshots.
+    */
+    template <>
+    struct ComponentSerialiser<AudioListener> : ByteSerialiser<AudioListener> {};
 }
 
 #endif //XY_AUDIO_LISTENER_HPP_
\ No newline at end of file
@@ -29,6 +29,7 @@ source distribution.
 #define XY_CAMERA_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/Graphics/View.hpp>
 
@@ -134,6 +135,13 @@ namespace xy
         friend class Scene;
         friend class CameraSystem;
     };
+
+    /*!
+    \brief Cameras hold only their view and lock settings, so are copied
+    byte for byte in snapshots.
+    */
+    template <>
+    struct ComponentSerialiser<Camera> : ByteSerialiser<Camera> {};
 }
 
 
@@ -29,6 +29,7 @@ source distribution.
 #define XY_COMMAND_TARGET_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/Config.hpp>
 
@@ -54,6 +55,12 @@ namespace xy
     {
         sf::Uint32 ID = 0;
     };
+
+    /*!
+    \brief Command targets are copied byte for byte in snapshots.
+    */
+    template <>
+    struct ComponentSerialiser<CommandTarget> : ByteSerialiser<CommandTarget> {};
 }
 
 #endif //XY_COMMAND_ID_HPP_
\ No newline at end of file
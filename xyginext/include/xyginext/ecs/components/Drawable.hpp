@@ -29,6 +29,7 @@ source distribution.
 #define XY_DRAWABLE_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/Vertex.hpp>
@@ -93,7 +94,14 @@ namespace xy
         inversely the greater the value the further forward it is drawn.
         Default value is 0.
         */
-        void setDepth(sf::Int32 depth) { m_zDepth = depth; m_wantsSorting = true; }
+        void setDepth(sf::Int32 depth)
+        {
+            if (depth != m_zDepth)
+            {
+                m_zDepth = depth;
+                m_wantsSorting = true;
+            }
+        }
 
         /*!
         \brief Returns the Z depth value
@@ -127,7 +135,11 @@ namespace xy
 
         /*!
         \brief Updates the local bounds.
-        This should be called once by a system when it updates the vertex array
+        This should be called once by a system when it updates the vertex array.
+        If the bounds may change after the RenderSystem has been processed,
+        the system should also mark the Drawable as changed with
+        Entity::markChanged(), so that culling uses the new bounds when the
+        Scene is next drawn rather than a frame later.
         */
         void updateLocalBounds();
 
@@ -140,9 +152,17 @@ namespace xy
         bool m_wantsSorting = true;
 
         sf::FloatRect m_localBounds;
+        bool m_boundsChanged = true;
 
         friend class RenderSystem;
     };
+
+    /*!
+    \brief Drawables are read by the RenderSystem every frame, so
+    group them with the other components of each entity.
+    */
+    template <>
+    struct UseChunkedStorage<Drawable> : std::true_type {};
 }
 
 #endif //XY_DRAWABLE_HPP_
\ No newline at end of file
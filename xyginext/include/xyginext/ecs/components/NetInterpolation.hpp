@@ -29,6 +29,7 @@ source distribution.
 #define XY_NET_INTERPOLATE_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 #include <SFML/Config.hpp>
 
 namespace xy
@@ -72,6 +73,12 @@ namespace xy
 
         friend class InterpolationSystem;
     };
+
+    /*!
+    \brief Interpolation state is copied byte for byte in snapshots.
+    */
+    template <>
+    struct ComponentSerialiser<NetInterpolate> : ByteSerialiser<NetInterpolate> {};
 }
 
 #endif //XY_NET_INTERPOLATE_HPP_
\ No newline at end of file
@@ -29,6 +29,7 @@ source distribution.
 #define XY_PARTICLE_EMITTER_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/System/Vector2.hpp>
 #include <SFML/System/Clock.hpp>
@@ -133,6 +134,27 @@ namespace xy
         sf::Int32 m_releaseCount;
 
         friend class ParticleSystem;
+        friend struct ComponentSerialiser<ParticleEmitter>;
+    };
+
+    /*!
+    \brief Emitters hold all of their particles inline, so they are
+    stored sparsely rather than reserving one per entity.
+    */
+    template <>
+    struct UseSparseStorage<ParticleEmitter> : std::true_type {};
+
+    /*!
+    \brief Snapshots contain an emitter's settings, its live particles
+    and whether it is running. The settings' texture is a resource owned
+    by the application, so emitters read from a snapshot keep the texture
+    they already have, and the emission clock restarts from zero.
+    */
+    template <>
+    struct XY_EXPORT_API ComponentSerialiser<ParticleEmitter> : std::true_type
+    {
+        static void write(const ParticleEmitter&, std::vector<char>&);
+        static bool read(ParticleEmitter&, SnapshotReader&);
     };
 }
 
@@ -29,6 +29,7 @@ source distribution.
 #define XY_QUAD_TREE_ITEM_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/Graphics/Rect.hpp>
 
@@ -51,12 +52,27 @@ namespace xy
 
     private:
         sf::FloatRect m_area;
+        sf::FloatRect m_worldBounds; //m_area in world space, updated by the QuadTree each frame
 
         QuadTree* m_quadTree;
         QuadTreeNode* m_node;
 
         friend class QuadTree;
         friend class QuadTreeNode;
+        friend struct ComponentSerialiser<QuadTreeItem>;
+    };
+
+    /*!
+    \brief Snapshots contain only the item's area. An item which is
+    already in a QuadTree stays in its current node until the tree is
+    next processed, and items created by a restore are placed in the
+    tree when their entity is added to the QuadTree system.
+    */
+    template <>
+    struct XY_EXPORT_API ComponentSerialiser<QuadTreeItem> : std::true_type
+    {
+        static void write(const QuadTreeItem&, std::vector<char>&);
+        static bool read(QuadTreeItem&, SnapshotReader&);
     };
 }
 
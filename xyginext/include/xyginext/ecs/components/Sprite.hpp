@@ -29,6 +29,7 @@ source distribution.
 #define XY_SPRITE_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/Vertex.hpp>
@@ -158,6 +159,34 @@ namespace xy
         friend class SpriteSystem;
         friend class SpriteSheet;
         friend class SpriteAnimator;
+        friend struct ComponentSerialiser<Sprite>;
+    };
+
+    /*!
+    \brief Sprites carry their complete animation table, so use
+    sparse storage to avoid paying for it on entities without one.
+    */
+    template <>
+    struct UseSparseStorage<Sprite> : std::true_type {};
+
+    /*!
+    \brief Sprite geometry is only rebuilt by the SpriteSystem
+    when the Sprite component has been marked as changed.
+    */
+    template <>
+    struct TrackChanges<Sprite> : std::true_type {};
+
+    /*!
+    \brief Snapshots contain a Sprite's texture rectangle, colour and
+    the animations in use. The texture is a resource owned by the
+    application, so Sprites read from a snapshot keep the texture they
+    already have, which is none if the Sprite is created by the restore.
+    */
+    template <>
+    struct XY_EXPORT_API ComponentSerialiser<Sprite> : std::true_type
+    {
+        static void write(const Sprite&, std::vector<char>&);
+        static bool read(Sprite&, SnapshotReader&);
     };
 }
 
@@ -29,6 +29,7 @@ source distribution.
 #define XY_SPRITE_ANIMATION_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 #include <SFML/Config.hpp>
 
 namespace xy
@@ -68,6 +69,13 @@ namespace xy
 
         friend class SpriteAnimator;
     };
+
+    /*!
+    \brief Playback state refers to animations by index, so is
+    copied byte for byte in snapshots.
+    */
+    template <>
+    struct ComponentSerialiser<SpriteAnimation> : ByteSerialiser<SpriteAnimation> {};
 }
 
 #endif //XY_SPRITE_ANIMATION_HPP_
\ No newline at end of file
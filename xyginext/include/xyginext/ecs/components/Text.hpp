@@ -29,6 +29,7 @@ source distribution.
 #define XY_TEXT_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/System/String.hpp>
 #include <SFML/Graphics/Rect.hpp>
@@ -176,6 +177,13 @@ namespace xy
 
         friend class TextRenderer;
     };
+
+    /*!
+    \brief Text geometry is only rebuilt by the TextRenderer
+    when the Text component has been marked as changed.
+    */
+    template <>
+    struct TrackChanges<Text> : std::true_type {};
 }
 
 #endif //XY_TEXT_HPP_
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_TILEMAP_HPP_
+#define XY_TILEMAP_HPP_
+
+#include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
+
+#include <SFML/Config.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#if SFML_VERSION_MAJOR == 2 && SFML_VERSION_MINOR >= 5
+#define XY_TILEMAP_VERTEX_BUFFER
+#include <SFML/Graphics/VertexBuffer.hpp>
+#endif
+
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <limits>
+
+namespace sf
+{
+    class Texture;
+}
+
+namespace xy
+{
+    /*!
+    \brief Component for drawing large static maps made from tiles, such as
+    the tile layers of a Tiled TMX map.
+    The TileMapSystem bakes each layer in to chunks of a fixed number of tiles,
+    with one vertex array per tileset used in the chunk, so that only chunks
+    overlapping the view are drawn. When built with SFML 2.5 or later the chunk
+    geometry is stored in an sf::VertexBuffer, where available. Layers are drawn
+    in the order in which they were added. Tile maps require their entity to
+    also have a Transform component.
+    */
+    class XY_EXPORT_API TileMap final
+    {
+    public:
+        /*!
+        \brief Flags which may be set in the upper bits of a tile ID,
+        matching those used by Tiled.
+        */
+        enum Flip : sf::Uint32
+        {
+            Horizontal = 0x80000000,
+            Vertical = 0x40000000,
+            Diagonal = 0x20000000
+        };
+
+        /*!
+        \brief Describes a texture containing a grid of tiles
+        */
+        struct Tileset final
+        {
+            const sf::Texture* texture = nullptr;
+            sf::Uint32 firstID = 1; //!< ID of the first tile in the set
+            sf::Uint32 tileCount = 0;
+            sf::Uint32 columns = 0;
+            sf::Vector2u tileSize; //!< Size of a tile in the texture, in pixels
+            sf::Uint32 margin = 0; //!< Space around the edge of the texture, in pixels
+            sf::Uint32 spacing = 0; //!< Space between tiles, in pixels
+        };
+
+        /*!
+        \brief A single frame of a tile animation
+        */
+        struct AnimationFrame final
+        {
+            sf::Uint32 tileID = 0;
+            float duration = 0.1f; //!< Seconds
+        };
+
+        /*!
+        \brief Returned by addLayer() if the layer couldn't be added
+        */
+        static constexpr std::size_t InvalidLayer = std::numeric_limits<std::size_t>::max();
+
+        TileMap();
+
+        /*!
+        \brief Sets the size of each tile in world units.
+        Defaults to 16x16
+        */
+        void setTileSize(sf::Vector2f);
+
+        /*!
+        \brief Returns the size of each tile in world units
+        */
+        sf::Vector2f getTileSize() const { return m_tileSize; }
+
+        /*!
+        \brief Sets the number of tiles in each chunk.
+        Smaller chunks are culled more accurately but need more draw calls
+        to cover the view. Defaults to 32x32
+        */
+        void setChunkSize(sf::Vector2u);
+
+        /*!
+        \brief Returns the number of tiles in each chunk
+        */
+        sf::Vector2u getChunkSize() const { return m_chunkSize; }
+
+        /*!
+        \brief Adds a tileset. The texture must exist for the lifetime
+        of the tile map. Tile IDs used by layers and animations are
+        looked up in the tileset which contains them.
+        */
+        void addTileset(const Tileset&);
+
+        /*!
+        \brief Adds a layer of tiles.
+        \param tiles Row major list of tile IDs, including any Flip flags.
+        An ID of 0 is an empty tile.
+        \param size Number of tiles in each row and column of the layer
+        \returns Index of the new layer, or InvalidLayer if the number
+        of tiles doesn't match the size, in which case nothing is added
+        */
+        std::size_t addLayer(const std::vector<sf::Uint32>& tiles, sf::Vector2u size);
+
+        /*!
+        \brief Animates every instance of the given tile with the given frames.
+        Only the vertices of the animated tiles are updated when the frame changes.
+        All frames must be from the same tileset as the animated tile.
+        Animations with no frames, or with a frame whose duration isn't
+        greater than zero, are not added.
+        */
+        void addAnimation(sf::Uint32 tileID, const std::vector<AnimationFrame>& frames);
+
+        /*!
+        \brief Removes all layers, tilesets and animations
+        */
+        void clear();
+
+        /*!
+        \brief Returns the local bounds of all the map's layers
+        */
+        sf::FloatRect getLocalBounds() const;
+
+        /*!
+        \brief Returns the number of chunks the map was baked in to
+        */
+        std::size_t getChunkCount() const { return m_chunks.size(); }
+
+    private:
+        sf::Vector2f m_tileSize;
+        sf::Vector2u m_chunkSize;
+        bool m_dirty;
+
+        std::vector<Tileset> m_tilesets;
+
+        struct Layer final
+        {
+            std::vector<sf::Uint32> tiles;
+            sf::Vector2u size;
+        };
+        std::vector<Layer> m_layers;
+
+        //a tile using an animation, found when the map is built
+        struct AnimatedTile final
+        {
+            std::size_t chunk = 0;
+            std::size_t vertex = 0;
+            sf::Uint32 flags = 0;
+        };
+
+        struct Animation final
+        {
+            std::vector<AnimationFrame> frames;
+            float duration = 0.f; //sum of all the frame durations
+            std::size_t currentFrame = 0;
+            float elapsed = 0.f;
+            std::vector<AnimatedTile> tiles;
+        };
+        std::vector<Animation> m_animations;
+        std::unordered_map<sf::Uint32, std::size_t> m_animationIndices;
+
+        struct Chunk final
+        {
+            sf::FloatRect bounds;
+            std::size_t tileset = 0;
+            std::vector<sf::Vertex> vertices;
+
+            bool animated = false;
+
+            //range of vertices modified since they were last uploaded
+            std::size_t dirtyStart = 0;
+            std::size_t dirtyEnd = 0;
+#ifdef XY_TILEMAP_VERTEX_BUFFER
+            std::unique_ptr<sf::VertexBuffer> buffer; //created when first drawn
+#endif
+        };
+        std::vector<Chunk> m_chunks;
+
+        friend class TileMapSystem;
+    };
+
+    /*!
+    \brief Tile maps are few and large, so keep them out of dense storage
+    */
+    template <>
+    struct UseSparseStorage<TileMap> : std::true_type {};
+}
+
+#endif //XY_TILEMAP_HPP_
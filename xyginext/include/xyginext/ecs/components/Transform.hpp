@@ -29,23 +29,31 @@ source distribution.
 #define XY_TRANSFORM_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/Graphics/Transformable.hpp>
 
 #include <vector>
+#include <limits>
 
 namespace xy
 {
     /*!
     \brief Wraps the SFML transformable class in a component
     friendly format, parentable to other transforms in a scene graph hierachy.
+    Parents and children are referred to by entity index, so only Transforms
+    which have been added to an entity can be parented. World transforms are
+    cached, and updated breadth first once per Scene update for any branch of
+    the hierarchy which has been modified. Each Transform whose world transform
+    is updated is marked as changed, so systems can find moved entities with
+    System::getChanged<Transform>().
     Transforms are non-copyable, but are moveable
     */
     class XY_EXPORT_API Transform final : public sf::Transformable
     {
     public:
         Transform();
-        ~Transform();
+        ~Transform() = default;
 
         Transform(const Transform&) = delete;
         Transform(Transform&&);
@@ -53,7 +61,8 @@ namespace xy
         Transform& operator = (Transform&&);
 
         /*!
-        \brief Adds a child transform to this one
+        \brief Adds a child transform to this one.
+        Both transforms must belong to entities in the same Scene.
         */
         void addChild(Transform&);
 
@@ -64,8 +73,12 @@ namespace xy
         void removeChild(Transform&);
 
         /*!
-        \brief Returns the world position of this transform by
-        multiplying it with any parent transforms it may have
+        \brief Returns the world transform by multiplying this transform
+        with any parent transforms it may have. This is cached, unless this
+        transform or one of its parents has been modified since the Scene
+        was last updated. This doesn't modify any Transform, so it may be
+        called from several threads at once provided none of them modify
+        this transform or its parents.
         */
         sf::Transform getWorldTransform() const;
 
@@ -77,9 +90,96 @@ namespace xy
         */
         sf::Vector2f getWorldPosition() const;
 
+        /*!
+        \brief These hide the sf::Transformable functions of the same
+        name so that modifying a Transform invalidates the cached world
+        transforms of it and its children. Transforms should therefore
+        not be modified through a reference to sf::Transformable.
+        Only the modified Transform is marked, and its children are marked
+        when the Scene next updates, so different Transforms can be modified
+        from several threads at once, such as with JobSystem::parallelFor().
+        */
+        void setPosition(float, float);
+        void setPosition(const sf::Vector2f&);
+        void setRotation(float);
+        void setScale(float, float);
+        void setScale(const sf::Vector2f&);
+        void setOrigin(float, float);
+        void setOrigin(const sf::Vector2f&);
+        void move(float, float);
+        void move(const sf::Vector2f&);
+        void rotate(float);
+        void scale(float, float);
+        void scale(const sf::Vector2f&);
+
     private:
-        Transform* m_parent;
-        std::vector<Transform*> m_children;
+        static constexpr sf::Uint32 NoEntity = std::numeric_limits<sf::Uint32>::max();
+
+        //the pool and entity index this transform belongs to, if it has been added to an entity
+        Detail::Pool* m_pool;
+        sf::Uint32 m_entity;
+
+        sf::Uint32 m_parent;
+        std::vector<sf::Uint32> m_children;
+
+        sf::Transform m_worldTransform;
+        bool m_dirty; //true if this has changed since m_worldTransform was updated. Parents may be dirty when this isn't.
+
+        Transform& getRelative(sf::Uint32) const;
+        sf::Transform getLocalTransform() const;
+        void markDirty();
+        void unlink();
+        void updateBranch(std::vector<sf::Uint32>&);
+
+        friend struct ComponentAttachment<Transform>;
+        friend struct ComponentSerialiser<Transform>;
+        friend class Scene;
+    };
+
+    /*!
+    \brief Transforms are grouped by component mask so that systems
+    iterate them linearly. As Transforms may move between tables when
+    the Scene updates, hierarchies refer to each other by entity index.
+    */
+    template <>
+    struct UseChunkedStorage<Transform> : std::true_type {};
+
+    /*!
+    \brief Tells a Transform which entity it belongs to, so that it
+    can find its parent and children. Removing a Transform from its
+    entity unparents it, and any children it has.
+    */
+    template <>
+    struct XY_EXPORT_API ComponentAttachment<Transform> : std::true_type
+    {
+        static void attach(Transform&, std::size_t, Detail::Pool&);
+        static void detach(Transform&);
+    };
+
+    /*!
+    \brief Copies of a Transform take only its local position,
+    rotation, scale and origin. The copy has no parent or children.
+    */
+    template <>
+    struct XY_EXPORT_API ComponentCopy<Transform>
+    {
+        static Transform copy(const Transform&);
+    };
+
+    /*!
+    \brief Snapshots contain the local position, rotation, scale and
+    origin of each Transform, along with the entity indices of its parent
+    and children, so restoring a snapshot also restores the hierarchy
+    as it was when the snapshot was taken. World transforms are updated
+    when the Scene next updates. Snapshots whose hierarchy refers to
+    entities without a Transform, or which contains a cycle, are rejected.
+    */
+    template <>
+    struct XY_EXPORT_API ComponentSerialiser<Transform> : std::true_type
+    {
+        static void write(const Transform&, std::vector<char>&);
+        static bool read(Transform&, SnapshotReader&);
+        static bool validate(const std::vector<Transform>&, const std::vector<sf::Uint32>&);
     };
 }
 
@@ -29,6 +29,7 @@ source distribution.
 #define XY_UI_HITBOX_HPP_
 
 #include <xyginext/Config.hpp>
+#include <xyginext/ecs/Component.hpp>
 
 #include <SFML/Config.hpp>
 #include <SFML/Graphics/Rect.hpp>
@@ -64,6 +65,13 @@ namespace xy
         std::array<sf::Uint32, CallbackID::Count> callbacks{};
         sf::Int32 ID = -1;
     };
+
+    /*!
+    \brief Hit box callbacks are stored as IDs rather than functions,
+    so are copied byte for byte in snapshots.
+    */
+    template <>
+    struct ComponentSerialiser<UIHitBox> : ByteSerialiser<UIHitBox> {};
 }
 
 #endif //XY_UI_HITBOX_HPP_
@@ -31,15 +31,35 @@ source distribution.
 #include <xyginext/ecs/System.hpp>
 
 #include <SFML/Graphics/Drawable.hpp>
+#include <SFML/Graphics/Vertex.hpp>
+#include <SFML/Graphics/BlendMode.hpp>
+#include <SFML/Graphics/Rect.hpp>
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace xy
 {
+    class Drawable;
+
     /*!
     \brief Used to draw all entities which have a Drawable and Transform component.
     The RenderSystem is used to depth sort and draw all entities which have a 
     Drawable and Transform component attached, and optionally a Sprite component.
     NOTE multiple components which rely on a Drawable component cannot exist on the same entity,
     as only one set of vertices will be available.
+
+    Consecutive drawables in depth order which share the same texture, shader, blend mode
+    and primitive type are batched in to a single draw call. The vertices of batched
+    drawables are transformed on the CPU, so a shader used with batched drawables receives
+    vertex positions in world space rather than local space. Drawables using strip or fan
+    primitive types are always drawn individually.
+
+    Drawables are ordered by a sort key made from their depth, followed by their texture,
+    shader and blend mode, so that drawables at the same depth are grouped in a way which
+    allows them to be batched. The draw order of drawables with the same depth and states
+    is unspecified.
     */
     class XY_EXPORT_API RenderSystem final : public xy::System, public sf::Drawable 
     {
@@ -48,10 +68,117 @@ namespace xy
 
         void process(float) override;
 
+        /*!
+        \brief Enables or disables batching of drawables.
+        Batching is enabled by default.
+        */
+        void setBatchingEnabled(bool enabled) { m_batchingEnabled = enabled; }
+
+        /*!
+        \brief Returns true if batching is enabled
+        */
+        bool getBatchingEnabled() const { return m_batchingEnabled; }
+
+        /*!
+        \brief Returns the number of draw calls made when the system was last drawn
+        */
+        std::size_t getDrawCallCount() const { return m_drawCallCount; }
+
+        /*!
+        \brief Returns the number of vertices drawn when the system was last drawn
+        */
+        std::size_t getVertexCount() const { return m_vertexCount; }
+
+        /*!
+        \brief Returns the number of drawables which passed culling when the system
+        was last drawn. Without batching this would be the number of draw calls.
+        */
+        std::size_t getVisibleCount() const { return m_visibleCount; }
+
+        /*!
+        \brief Enables or disables spatial culling.
+        When enabled the world bounds of each drawable are cached in a grid, and
+        only drawables in grid cells overlapping the view are tested for visibility,
+        rather than every drawable each frame. This suits large scenes where most
+        drawables are off screen. Cached bounds are updated when an entity's world
+        transform changes, and when its Drawable's local bounds change the next time
+        this system is processed. Spatial culling is disabled by default.
+        \param enabled True to enable spatial culling
+        \param cellSize Width and height of each grid cell in world units. This should
+        be a few times larger than a typical drawable.
+        */
+        void setSpatialCullingEnabled(bool enabled, float cellSize = 256.f);
+
+        /*!
+        \brief Returns true if spatial culling is enabled
+        */
+        bool getSpatialCullingEnabled() const { return m_cullingEnabled; }
+
     private:
-        bool m_wantsSorting;
+        bool m_batchingEnabled;
+
+        struct DrawEntry final
+        {
+            sf::Uint64 key = 0;
+            Entity entity;
+        };
+        //entities in draw order. Entries past m_sortedCount
+        //have been added since the list was last sorted
+        std::vector<DrawEntry> m_drawList;
+        std::vector<DrawEntry> m_changedEntries;
+        std::vector<DrawEntry> m_sortBuffer;
+        std::size_t m_sortedCount;
+        std::unordered_set<Entity::Handle> m_removedEntities;
+
+        //small IDs for render states, packed in to the sort key
+        std::unordered_map<const void*, sf::Uint32> m_textureIDs;
+        std::unordered_map<const void*, sf::Uint32> m_shaderIDs;
+        std::vector<sf::BlendMode> m_blendModes;
+
+        //cached world bounds and grid location, indexed by entity index
+        struct CullingInfo final
+        {
+            enum
+            {
+                None, Cells, Large
+            }location = None;
+            bool dirty = false;
+            sf::FloatRect bounds;
+            sf::Int32 left = 0; //range of cells covered, inclusive
+            sf::Int32 top = 0;
+            sf::Int32 right = 0;
+            sf::Int32 bottom = 0;
+            sf::Uint32 drawIndex = 0; //position in m_drawList
+            sf::Uint32 queryID = 0; //last query which found this entity
+        };
+        bool m_cullingEnabled;
+        float m_cellSize;
+        bool m_drawOrderChanged;
+        sf::Uint32 m_queryID;
+        std::vector<CullingInfo> m_cullingInfo;
+        std::unordered_map<sf::Uint64, std::vector<sf::Uint32>> m_cells;
+        std::vector<sf::Uint32> m_largeEntities; //too big to be worth putting in cells
+        std::vector<Entity> m_dirtyEntities;
+        std::vector<sf::Uint32> m_visibleEntries;
+
+        mutable std::vector<sf::Vertex> m_batchVertices;
+        mutable std::size_t m_drawCallCount;
+        mutable std::size_t m_vertexCount;
+        mutable std::size_t m_visibleCount;
 
         void onEntityAdded(xy::Entity) override;
+        void onEntityRemoved(xy::Entity) override;
+
+        sf::Uint64 getSortKey(const xy::Drawable&);
+        void mergeChanged();
+        void radixSort();
+
+        void markDirty(Entity);
+        void updateCulling();
+        void addToGrid(sf::Uint32);
+        void removeFromGrid(sf::Uint32);
+        void queryGrid(const sf::FloatRect&);
+
         void draw(sf::RenderTarget&, sf::RenderStates) const override;
     };
 }
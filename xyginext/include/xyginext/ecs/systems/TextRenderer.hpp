@@ -51,6 +51,7 @@ namespace xy
         std::vector<Entity> m_texts;
         std::vector<Entity> m_croppedTexts;
 
+        void onEntityAdded(Entity) override;
         void draw(sf::RenderTarget&, sf::RenderStates) const override;
     };
 }
@@ -0,0 +1,70 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_TILEMAP_SYSTEM_HPP_
+#define XY_TILEMAP_SYSTEM_HPP_
+
+#include <xyginext/ecs/System.hpp>
+
+#include <SFML/Graphics/Drawable.hpp>
+
+namespace xy
+{
+    class TileMap;
+
+    /*!
+    \brief Builds and draws entities with a TileMap and Transform component.
+    Maps are rebuilt only when they are modified, after which the system
+    updates the vertices of any animated tiles. As this system draws
+    independently of the RenderSystem it should usually be added to the
+    Scene before the RenderSystem, so that maps are drawn behind any
+    other drawables.
+    */
+    class XY_EXPORT_API TileMapSystem final : public xy::System, public sf::Drawable
+    {
+    public:
+        explicit TileMapSystem(MessageBus&);
+
+        void process(float) override;
+
+        /*!
+        \brief Returns the number of chunks drawn when the system was last drawn
+        */
+        std::size_t getDrawnChunkCount() const { return m_drawnChunkCount; }
+
+    private:
+        std::vector<Entity> m_maps;
+        mutable std::size_t m_drawnChunkCount;
+
+        void build(TileMap&);
+        void updateAnimations(TileMap&, float);
+
+        void draw(sf::RenderTarget&, sf::RenderStates) const override;
+    };
+}
+
+#endif //XY_TILEMAP_SYSTEM_HPP_
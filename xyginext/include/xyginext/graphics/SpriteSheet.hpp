@@ -68,9 +68,18 @@ namespace xy
         */
         std::size_t getAnimationIndex(const std::string& name, const std::string& sprite) const;
 
+        /*!
+        \brief Returns the path of the texture used by this sprite sheet,
+        as it appears in the sheet's src property.
+        */
+        const std::string& getTexturePath() const { return m_texturePath; }
+
     private:
+        std::string m_texturePath;
         mutable std::unordered_map<std::string, Sprite> m_sprites;
         mutable std::unordered_map<std::string, std::vector<std::string>> m_animations;
+
+        friend class TextureAtlas;
     };
 }
 
@@ -0,0 +1,205 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#ifndef XY_TEXTURE_ATLAS_HPP_
+#define XY_TEXTURE_ATLAS_HPP_
+
+#include <xyginext/Config.hpp>
+
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/Rect.hpp>
+#include <SFML/Graphics/Texture.hpp>
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace xy
+{
+    class Sprite;
+    class SpriteSheet;
+
+    /*!
+    \brief Packs multiple images into a small number of large texture
+    pages at run time.
+    Sprites drawn from the same page share a texture and can therefore
+    be batched together by the renderer. Images are added by their file
+    path, or by name from an existing sf::Image, then pack() is called to
+    create the pages. The result can be written to disk with saveToFile()
+    so that subsequent runs can skip packing entirely:
+    \code
+    xy::TextureAtlas atlas;
+    atlas.addSpriteSheet(playerSheet);
+    atlas.addSpriteSheet(enemySheet);
+    if (!atlas.loadFromFile("cache/sprites.atlas"))
+    {
+        atlas.pack();
+        atlas.saveToFile("cache/sprites.atlas");
+    }
+    atlas.apply(playerSheet);
+    atlas.apply(enemySheet);
+    \endcode
+    Note that the atlas owns the page textures, so it must outlive
+    any sprites which have been applied to it.
+    */
+    class XY_EXPORT_API TextureAtlas final
+    {
+    public:
+        /*!
+        \brief Describes where an image has been placed in the atlas
+        */
+        struct Region final
+        {
+            std::size_t page = 0;
+            sf::IntRect bounds;
+        };
+
+        TextureAtlas();
+
+        TextureAtlas(const TextureAtlas&) = delete;
+        TextureAtlas& operator = (const TextureAtlas&) = delete;
+
+        /*!
+        \brief Sets the maximum size of each texture page.
+        Defaults to 2048x2048, which is supported by most hardware.
+        Images larger than this cannot be added to the atlas.
+        */
+        void setPageSize(sf::Vector2u);
+
+        /*!
+        \brief Sets the number of transparent pixels placed around
+        each image to prevent bleeding when textures are smoothed.
+        Defaults to 1
+        */
+        void setPadding(sf::Uint32);
+
+        /*!
+        \brief Sets the smoothing property of all texture pages
+        */
+        void setSmooth(bool);
+
+        /*!
+        \brief Adds an image file to the atlas. The image is not
+        loaded until pack() is called, and the path is also used
+        as the name of the image when looking up its region.
+        */
+        void addImage(const std::string& path);
+
+        /*!
+        \brief Adds an existing image to the atlas with the given name.
+        This can be used for images created at run time, for example
+        bitmap fonts.
+        */
+        void addImage(const std::string& name, const sf::Image& image);
+
+        /*!
+        \brief Adds the texture used by the given SpriteSheet
+        to the atlas.
+        */
+        void addSpriteSheet(const SpriteSheet&);
+
+        /*!
+        \brief Packs all added images into texture pages.
+        Any existing pages are discarded.
+        \returns false if one or more images failed to load
+        or were too large to fit on a page.
+        */
+        bool pack();
+
+        /*!
+        \brief Writes the packed pages to disk as PNG images along
+        with an index file at the given path. The pages are named
+        after the index file and saved in the same directory.
+        \returns true on success
+        */
+        bool saveToFile(const std::string& path) const;
+
+        /*!
+        \brief Attempts to load an atlas previously written with saveToFile().
+        If images have been added to the atlas the cache is only loaded
+        if it contains all of them and their files appear unmodified, else
+        this returns false and pack() should be used to rebuild the atlas.
+        */
+        bool loadFromFile(const std::string& path);
+
+        /*!
+        \brief Returns the number of texture pages in the atlas
+        */
+        std::size_t getPageCount() const { return m_pages.size(); }
+
+        /*!
+        \brief Returns the texture of the given page
+        */
+        const sf::Texture& getTexture(std::size_t page) const;
+
+        /*!
+        \brief Returns a pointer to the region of the given image
+        if it exists in the atlas, else nullptr
+        */
+        const Region* getRegion(const std::string& name) const;
+
+        /*!
+        \brief Updates the given sprite, which currently uses the texture
+        of the named image, so that it draws from the atlas instead. This
+        includes the texture rectangles of any animation frames.
+        \returns false if the image is not in the atlas
+        */
+        bool apply(Sprite& sprite, const std::string& name) const;
+
+        /*!
+        \brief Updates all the sprites in the given sheet to use the atlas.
+        Sprites which have already been retrieved from the sheet with
+        getSprite() are not affected, so this should be done before
+        creating any entities with the sheet's sprites.
+        \returns false if the sheet texture is not in the atlas
+        */
+        bool apply(SpriteSheet&) const;
+
+    private:
+        sf::Vector2u m_pageSize;
+        sf::Uint32 m_padding;
+        bool m_smooth;
+
+        struct Source final
+        {
+            std::string name;
+            std::unique_ptr<sf::Image> image; //null if loaded from file
+        };
+        std::vector<Source> m_sources;
+
+        struct Entry final
+        {
+            Region region;
+            sf::Int32 fileSize = -1;
+        };
+        std::unordered_map<std::string, Entry> m_entries;
+        std::vector<std::unique_ptr<sf::Texture>> m_pages;
+    };
+}
+
+#endif //XY_TEXTURE_ATLAS_HPP_
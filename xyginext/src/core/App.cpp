@@ -30,6 +30,8 @@ source distribution.
 #include <xyginext/core/Console.hpp>
 #include <xyginext/core/ConfigFile.hpp>
 #include <xyginext/core/FileSystem.hpp>
+#include <xyginext/core/JobSystem.hpp>
+#include <xyginext/core/Trace.hpp>
 #include <xyginext/detail/Operators.hpp>
 #include <xyginext/gui/GuiClient.hpp>
 
@@ -143,6 +145,7 @@ void App::run()
         {
             timeSinceLastUpdate -= timePerFrame;
             
+            TraceRecorder::beginFrame(timePerFrame);
             handleEvents();
             handleMessages();
 
@@ -161,6 +164,8 @@ void App::run()
     Console::finalise();
     finalise();
     ImGui::SFML::Shutdown();
+    JobSystem::shutdown();
+    TraceRecorder::stop();
 
     saveSettings();
 }
@@ -383,7 +388,11 @@ void App::handleEvents()
             }           
         }
         
-        if(!imguiConsumed) eventHandler(evt);
+        if (!imguiConsumed)
+        {
+            TraceRecorder::recordEvent(evt);
+            eventHandler(evt);
+        }
     }   
 }
 
@@ -393,6 +402,7 @@ void App::handleMessages()
     {
         auto msg = m_messageBus.poll();
 
+        TraceRecorder::recordMessage(msg);
         handleMessage(msg);
     } 
 }
@@ -543,6 +553,21 @@ void App::loadSettings()
                 }
             }
         }
+
+        //number of job system worker threads, negative for auto
+        auto jObj = std::find_if(objects.begin(), objects.end(),
+            [](const ConfigObject& o)
+        {
+            return o.getName() == "jobs";
+        });
+
+        if (jObj != objects.end())
+        {
+            if (auto* workers = jObj->findProperty("workers"))
+            {
+                JobSystem::setWorkerCount(workers->getValue<sf::Int32>());
+            }
+        }
     }
 }
 
@@ -561,6 +586,9 @@ void App::saveSettings()
     {
         aObj->addProperty("channel" + std::to_string(i), std::to_string(AudioMixer::getVolume(i)));
     }
+
+    auto* jObj = settings.addObject("jobs");
+    jObj->addProperty("workers", std::to_string(JobSystem::getWorkerCount()));
     
     settings.save(FileSystem::getConfigDirectory(APP_NAME) + settingsFile);
 }
\ No newline at end of file
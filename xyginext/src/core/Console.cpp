@@ -31,6 +31,7 @@ source distribution.
 #include <xyginext/core/App.hpp>
 #include <xyginext/core/SysTime.hpp>
 #include <xyginext/core/Assert.hpp>
+#include <xyginext/core/Trace.hpp>
 #include <xyginext/audio/Mixer.hpp>
 
 #include "../imgui/imgui.h"
@@ -450,6 +451,34 @@ void Console::init()
         App::quit();
     });
 
+    //records a trace of events and messages
+    addCommand("trace_start",
+        [](const std::string& param)
+    {
+        if (param.empty())
+        {
+            Console::print("Usage: trace_start <file> where <file> is the path to write the trace to");
+        }
+        else if (TraceRecorder::start(param))
+        {
+            Console::print("Recording trace to " + param);
+        }
+        else
+        {
+            Console::print("Failed to open " + param);
+        }
+    });
+
+    addCommand("trace_stop",
+        [](const std::string&)
+    {
+        if (TraceRecorder::isRecording())
+        {
+            TraceRecorder::stop();
+            Console::print("Stopped recording trace");
+        }
+    });
+
 
     //loads any convars which may have been saved
     convars.loadFromFile(FileSystem::getConfigDirectory(APP_NAME) + convarName);
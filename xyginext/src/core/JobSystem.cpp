@@ -0,0 +1,410 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/core/JobSystem.hpp>
+#include <xyginext/core/Log.hpp>
+#include <xyginext/core/Assert.hpp>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <algorithm>
+
+using namespace xy;
+
+namespace
+{
+    struct Job final
+    {
+        std::function<void()> func;
+        std::atomic<std::size_t>* counter = nullptr;
+        const void* context = nullptr;
+    };
+
+    struct JobQueue final
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    //one queue per worker, plus a final queue shared by
+    //any threads which are not workers, such as the main thread
+    std::vector<std::unique_ptr<JobQueue>> queues;
+    std::vector<std::thread> workers;
+
+    std::mutex stateMutex;
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<std::size_t> pendingJobs(0);
+    std::atomic<bool> running(false);
+    sf::Int32 requestedWorkers = -1;
+
+    const std::size_t NotAWorker = std::numeric_limits<std::size_t>::max();
+    thread_local std::size_t workerIndex = NotAWorker;
+    thread_local const void* threadContext = nullptr;
+
+    //number of batches per thread parallelFor aims for, so that
+    //workers which finish early have something left to steal
+    const std::size_t BatchesPerThread = 4;
+
+    std::size_t ownQueue()
+    {
+        return (workerIndex < workers.size()) ? workerIndex : workers.size();
+    }
+
+    void push(Job&& job)
+    {
+        job.context = threadContext;
+        auto& queue = *queues[ownQueue()];
+        {
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+        pendingJobs++;
+
+        //taking the lock makes sure a worker which is about to
+        //sleep sees the new job count before waiting
+        {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+        }
+        sleepCondition.notify_one();
+    }
+
+    bool tryPop(Job& job)
+    {
+        if (pendingJobs == 0)
+        {
+            return false;
+        }
+
+        //newest job from our own queue first as its data is
+        //most likely to still be in the cache...
+        const auto own = ownQueue();
+        {
+            auto& queue = *queues[own];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.back());
+                queue.jobs.pop_back();
+                pendingJobs--;
+                return true;
+            }
+        }
+
+        //...else steal the oldest job from someone else
+        const auto count = queues.size();
+        for (auto i = 1u; i < count; ++i)
+        {
+            auto& queue = *queues[(own + i) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                job = std::move(queue.jobs.front());
+                queue.jobs.pop_front();
+                pendingJobs--;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void runJob(Job& job)
+    {
+        auto* previousContext = threadContext;
+        threadContext = job.context;
+        job.func();
+        threadContext = previousContext;
+
+        job.counter->fetch_sub(1);
+    }
+
+    //executes outstanding jobs until the counter reaches zero
+    void waitFor(const std::atomic<std::size_t>& counter)
+    {
+        while (counter > 0)
+        {
+            Job job;
+            if (tryPop(job))
+            {
+                runJob(job);
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void workerLoop(std::size_t index)
+    {
+        workerIndex = index;
+        while (running)
+        {
+            Job job;
+            if (tryPop(job))
+            {
+                runJob(job);
+            }
+            else
+            {
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                sleepCondition.wait(lock, []() { return pendingJobs > 0 || !running; });
+            }
+        }
+    }
+
+    void start()
+    {
+        if (running) return;
+
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (running) return;
+
+        std::size_t count = 0;
+        if (requestedWorkers < 0)
+        {
+            auto hardwareCount = std::thread::hardware_concurrency();
+            count = (hardwareCount > 1) ? hardwareCount - 1 : 0;
+        }
+        else
+        {
+            count = static_cast<std::size_t>(requestedWorkers);
+        }
+
+        queues.clear();
+        for (auto i = 0u; i < count + 1; ++i)
+        {
+            queues.emplace_back(std::make_unique<JobQueue>());
+        }
+
+        running = true;
+        workers.reserve(count);
+        for (auto i = 0u; i < count; ++i)
+        {
+            workers.emplace_back(workerLoop, i);
+        }
+
+        Logger::log("Started " + std::to_string(count) + " worker threads", Logger::Type::Info);
+    }
+
+    void stop()
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!running) return;
+
+        {
+            std::lock_guard<std::mutex> sleepLock(sleepMutex);
+            running = false;
+        }
+        sleepCondition.notify_all();
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        workers.clear();
+        queues.clear();
+        pendingJobs = 0;
+    }
+
+    //makes sure threads are joined if used without xy::App
+    struct ShutdownGuard final
+    {
+        ~ShutdownGuard() { stop(); }
+    }shutdownGuard;
+}
+
+void JobSystem::setWorkerCount(sf::Int32 count)
+{
+    if (count != requestedWorkers)
+    {
+        stop();
+        requestedWorkers = count;
+    }
+}
+
+sf::Int32 JobSystem::getWorkerCount()
+{
+    return requestedWorkers;
+}
+
+std::size_t JobSystem::getActiveWorkerCount()
+{
+    start();
+    return workers.size();
+}
+
+void JobSystem::parallelFor(std::size_t count, const std::function<void(std::size_t, std::size_t)>& func, std::size_t minBatchSize)
+{
+    if (count == 0) return;
+
+    minBatchSize = std::max(std::size_t(1), minBatchSize);
+    const auto workerCount = getActiveWorkerCount();
+    if (workerCount == 0 || count <= minBatchSize)
+    {
+        func(0, count);
+        return;
+    }
+
+    const auto maxBatches = (workerCount + 1) * BatchesPerThread;
+    const auto targetBatches = std::min(maxBatches, (count + minBatchSize - 1) / minBatchSize);
+    const auto batchSize = (count + targetBatches - 1) / targetBatches;
+    const auto batchCount = (count + batchSize - 1) / batchSize;
+
+    std::atomic<std::size_t> counter(batchCount - 1);
+    for (auto i = 1u; i < batchCount; ++i)
+    {
+        const auto start = i * batchSize;
+        const auto end = std::min(count, start + batchSize);
+
+        Job job;
+        job.func = [&func, start, end]() { func(start, end); };
+        job.counter = &counter;
+        push(std::move(job));
+    }
+
+    //the first batch is run here rather than sitting idle
+    func(0, std::min(count, batchSize));
+    waitFor(counter);
+}
+
+void JobSystem::setContext(const void* context)
+{
+    threadContext = context;
+}
+
+const void* JobSystem::getContext()
+{
+    return threadContext;
+}
+
+void JobSystem::shutdown()
+{
+    stop();
+}
+
+//------task graph------//
+TaskGraph::TaskID TaskGraph::addTask(const std::function<void()>& task)
+{
+    m_tasks.emplace_back(std::make_unique<Task>());
+    m_tasks.back()->func = task;
+    return m_tasks.size() - 1;
+}
+
+void TaskGraph::addDependency(TaskID before, TaskID after)
+{
+    XY_ASSERT(before < m_tasks.size() && after < m_tasks.size(), "Invalid task ID");
+    XY_ASSERT(before != after, "Task cannot depend on itself");
+
+    m_tasks[before]->successors.push_back(after);
+    m_tasks[after]->dependencyCount++;
+}
+
+void TaskGraph::execute()
+{
+    if (m_tasks.empty()) return;
+
+#ifdef XY_DEBUG
+    //a cycle would never complete, so check all tasks are reachable
+    std::vector<std::size_t> counts(m_tasks.size());
+    std::vector<TaskID> ready;
+    for (auto i = 0u; i < m_tasks.size(); ++i)
+    {
+        counts[i] = m_tasks[i]->dependencyCount;
+        if (counts[i] == 0)
+        {
+            ready.push_back(i);
+        }
+    }
+    std::size_t visited = 0;
+    while (!ready.empty())
+    {
+        auto id = ready.back();
+        ready.pop_back();
+        visited++;
+        for (auto s : m_tasks[id]->successors)
+        {
+            if (--counts[s] == 0)
+            {
+                ready.push_back(s);
+            }
+        }
+    }
+    XY_ASSERT(visited == m_tasks.size(), "Task graph contains a cycle");
+#endif //XY_DEBUG
+
+    start();
+
+    std::atomic<std::size_t> counter(m_tasks.size());
+    for (auto& task : m_tasks)
+    {
+        task->remaining = task->dependencyCount;
+    }
+
+    for (auto i = 0u; i < m_tasks.size(); ++i)
+    {
+        if (m_tasks[i]->dependencyCount == 0)
+        {
+            submit(i, counter);
+        }
+    }
+    waitFor(counter);
+}
+
+void TaskGraph::clear()
+{
+    m_tasks.clear();
+}
+
+//private
+void TaskGraph::submit(TaskID id, std::atomic<std::size_t>& counter)
+{
+    Job job;
+    job.func = [this, id, &counter]()
+    {
+        auto& task = *m_tasks[id];
+        if (task.func)
+        {
+            task.func();
+        }
+
+        //successors are submitted before this task's count is
+        //released, so the counter can't reach zero early
+        for (auto s : task.successors)
+        {
+            if (--m_tasks[s]->remaining == 0)
+            {
+                submit(s, counter);
+            }
+        }
+    };
+    job.counter = &counter;
+    push(std::move(job));
+}
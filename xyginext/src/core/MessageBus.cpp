@@ -28,30 +28,53 @@ source distribution.
 #include <xyginext/core/MessageBus.hpp>
 #include <xyginext/core/Log.hpp>
 
+#include <algorithm>
+
 using namespace xy;
 
 namespace
 {
-    //max msg size is 128 bytes, so 128 messages
-    //maximum per frame is 16384 bytes
-    const std::size_t bufferSize = 16384u;
+    std::atomic<sf::Uint64> nextBusID(0);
+
+    //staging buffer used by this thread for each bus it has posted to.
+    //buses are identified by ID rather than address, which may be reused
+    struct StagingEntry final
+    {
+        sf::Uint64 busID = 0;
+        void* staging = nullptr;
+    };
+    thread_local std::vector<StagingEntry> threadStaging;
 }
 
+constexpr std::size_t MessageBus::MaxDataSize;
+constexpr std::size_t MessageBus::PageSize;
+constexpr std::size_t MessageBus::HeaderSize;
+
 MessageBus::MessageBus()
-    : m_currentBuffer   (bufferSize),
-    m_pendingBuffer     (bufferSize),
-    m_inPointer         (m_pendingBuffer.data()),
-    m_outPointer        (m_currentBuffer.data()),
-    m_currentCount      (0),
-    m_pendingCount      (0),
-    m_enabled           (true)
+    : m_uid         (nextBusID++),
+    m_readerThread (std::this_thread::get_id()),
+    m_inPage        (nullptr),
+    m_outPage       (0),
+    m_outOffset     (0),
+    m_currentCount  (0),
+    m_pendingCount  (0),
+    m_pendingBytes  (0),
+    m_disabledBuffer(MaxDataSize),
+    m_enabled       (true)
 {}
 
 const Message& MessageBus::poll()
 {
-    static auto size = sizeof(Message);
-    const Message& m = *reinterpret_cast<Message*>(m_outPointer);
-    m_outPointer += (size + m.m_dataSize);
+    XY_ASSERT(m_currentCount > 0, "No messages to poll");
+
+    if (m_outOffset == m_currentPages[m_outPage]->used)
+    {
+        m_outPage++;
+        m_outOffset = 0;
+    }
+
+    const Message& m = *reinterpret_cast<Message*>(m_currentPages[m_outPage]->data.get() + m_outOffset);
+    m_outOffset += HeaderSize + alignSize(m.m_dataSize);
     m_currentCount--;
 
     return m;
@@ -61,11 +84,50 @@ bool MessageBus::empty()
 {
     if (m_currentCount == 0)
     {
-        m_currentBuffer.swap(m_pendingBuffer);
-        m_inPointer = m_pendingBuffer.data();
-        m_outPointer = m_currentBuffer.data();
+        m_readerThread = std::this_thread::get_id();
+
+        //all the current messages have been read, so their pages can be reused
+        {
+            std::lock_guard<std::mutex> lock(m_freeMutex);
+            for (auto& page : m_currentPages)
+            {
+                page->used = 0;
+                m_freePages.push_back(std::move(page));
+            }
+        }
+        m_currentPages.clear();
+        m_currentPages.swap(m_pendingPages);
+
+        //messages from other threads follow those posted by this one.
+        //each thread's pages are appended whole so its messages stay in order
+        {
+            std::lock_guard<std::mutex> lock(m_stagingMutex);
+            for (auto& staging : m_staging)
+            {
+                std::lock_guard<std::mutex> stagingLock(staging->mutex);
+                for (auto& page : staging->pages)
+                {
+                    m_currentPages.push_back(std::move(page));
+                }
+                staging->pages.clear();
+                m_pendingCount += staging->messageCount;
+                m_pendingBytes += staging->byteCount;
+                staging->messageCount = 0;
+                staging->byteCount = 0;
+            }
+        }
+        m_inPage = nullptr;
+        m_outPage = 0;
+        m_outOffset = 0;
+
+        m_stats.messageCount = m_pendingCount;
+        m_stats.byteCount = m_pendingBytes;
+        m_stats.peakMessageCount = std::max(m_stats.peakMessageCount, m_pendingCount);
+        m_stats.peakByteCount = std::max(m_stats.peakByteCount, m_pendingBytes);
+
         m_currentCount = m_pendingCount;
         m_pendingCount = 0;
+        m_pendingBytes = 0;
         return true;
     }
     return false;
@@ -74,4 +136,63 @@ bool MessageBus::empty()
 std::size_t MessageBus::pendingMessageCount() const
 {
     return m_pendingCount;
-}
\ No newline at end of file
+}
+
+//private
+char* MessageBus::allocate(Staging& staging, std::size_t size)
+{
+    if (staging.pages.empty() || staging.pages.back()->used + size > PageSize)
+    {
+        staging.pages.push_back(getFreePage());
+    }
+
+    auto& page = *staging.pages.back();
+    auto* ptr = page.data.get() + page.used;
+    page.used += size;
+    staging.messageCount++;
+    staging.byteCount += size;
+    return ptr;
+}
+
+MessageBus::Staging& MessageBus::getStaging()
+{
+    for (const auto& entry : threadStaging)
+    {
+        if (entry.busID == m_uid)
+        {
+            return *static_cast<Staging*>(entry.staging);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_stagingMutex);
+    m_staging.emplace_back(std::make_unique<Staging>());
+
+    StagingEntry entry;
+    entry.busID = m_uid;
+    entry.staging = m_staging.back().get();
+    threadStaging.push_back(entry);
+
+    return *m_staging.back();
+}
+
+std::unique_ptr<MessageBus::Page> MessageBus::getFreePage()
+{
+    std::lock_guard<std::mutex> lock(m_freeMutex);
+    if (m_freePages.empty())
+    {
+        auto page = std::make_unique<Page>();
+        page->data = std::make_unique<char[]>(PageSize);
+        m_stats.pageCount++;
+        return page;
+    }
+
+    auto page = std::move(m_freePages.back());
+    m_freePages.pop_back();
+    return page;
+}
+
+void MessageBus::nextPage()
+{
+    m_pendingPages.push_back(getFreePage());
+    m_inPage = m_pendingPages.back().get();
+}
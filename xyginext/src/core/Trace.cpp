@@ -0,0 +1,409 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/core/Trace.hpp>
+#include <xyginext/core/Message.hpp>
+#include <xyginext/core/Log.hpp>
+#include <xyginext/core/Assert.hpp>
+
+#include <SFML/Window/Event.hpp>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <cstring>
+#include <limits>
+#include <cstddef>
+
+using namespace xy;
+
+namespace
+{
+    //file header, followed by a stream of records each starting with a RecordType
+    const char Magic[] = { 'X', 'Y', 'T', 'R' };
+    const sf::Uint32 Version = 1;
+
+    enum RecordType : sf::Uint8
+    {
+        FrameRecord,  //Uint32 frame number, float dt
+        EventRecord,  //sf::Event
+        MessageRecord //Int32 ID, Uint8 size, data
+    };
+
+    //buffers are handed to the writer thread once they reach this size
+    const std::size_t FlushSize = 32 * 1024;
+
+    using Buffer = std::unique_ptr<std::vector<char>>;
+
+    std::atomic<bool> recording(false);
+    bool frameStarted = false; //nothing is recorded until the first frame starts
+    sf::Uint32 frameCount = 0;
+    Buffer activeBuffer;
+
+    std::ofstream file;
+    std::thread writer;
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::vector<Buffer> writeQueue;
+    std::vector<Buffer> freeBuffers;
+    bool stopWriter = false;
+
+    template <typename T>
+    void write(const T& value)
+    {
+        const auto* bytes = reinterpret_cast<const char*>(&value);
+        activeBuffer->insert(activeBuffer->end(), bytes, bytes + sizeof(T));
+    }
+
+    void writerLoop()
+    {
+        std::vector<Buffer> buffers;
+        bool done = false;
+        while (!done)
+        {
+            {
+                std::unique_lock<std::mutex> lock(queueMutex);
+                queueCondition.wait(lock, []() { return !writeQueue.empty() || stopWriter; });
+                buffers.swap(writeQueue);
+                done = stopWriter;
+            }
+
+            for (auto& buffer : buffers)
+            {
+                file.write(buffer->data(), buffer->size());
+                buffer->clear();
+            }
+
+            std::lock_guard<std::mutex> lock(queueMutex);
+            for (auto& buffer : buffers)
+            {
+                freeBuffers.push_back(std::move(buffer));
+            }
+            buffers.clear();
+        }
+        file.flush();
+    }
+
+    void flush()
+    {
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            writeQueue.push_back(std::move(activeBuffer));
+
+            if (freeBuffers.empty())
+            {
+                activeBuffer = std::make_unique<std::vector<char>>();
+                activeBuffer->reserve(FlushSize * 2);
+            }
+            else
+            {
+                activeBuffer = std::move(freeBuffers.back());
+                freeBuffers.pop_back();
+            }
+        }
+        queueCondition.notify_one();
+    }
+
+    struct ShutdownGuard final
+    {
+        ~ShutdownGuard() { TraceRecorder::stop(); }
+    }shutdownGuard;
+}
+
+bool TraceRecorder::start(const std::string& path)
+{
+    stop();
+
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open() || !file.good())
+    {
+        Logger::log("Failed opening " + path + " for trace recording", Logger::Type::Error);
+        file.close();
+        return false;
+    }
+
+    activeBuffer = std::make_unique<std::vector<char>>();
+    activeBuffer->reserve(FlushSize * 2);
+    activeBuffer->insert(activeBuffer->end(), std::begin(Magic), std::end(Magic));
+    write(Version);
+    write(static_cast<sf::Uint32>(sizeof(sf::Event)));
+
+    frameCount = 0;
+    frameStarted = false;
+    stopWriter = false;
+    writer = std::thread(writerLoop);
+    recording = true;
+
+    Logger::log("Started recording trace to " + path, Logger::Type::Info);
+    return true;
+}
+
+void TraceRecorder::stop()
+{
+    if (!recording) return;
+
+    recording = false;
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopWriter = true;
+    }
+    queueCondition.notify_one();
+    writer.join();
+
+    file.close();
+    activeBuffer.reset();
+    freeBuffers.clear();
+}
+
+bool TraceRecorder::isRecording()
+{
+    return recording;
+}
+
+void TraceRecorder::beginFrame(float dt)
+{
+    if (!recording) return;
+
+    if (activeBuffer->size() >= FlushSize)
+    {
+        flush();
+    }
+
+    write(RecordType::FrameRecord);
+    write(frameCount++);
+    frameStarted = true;
+    write(dt);
+}
+
+void TraceRecorder::recordEvent(const sf::Event& evt)
+{
+    if (!recording || !frameStarted) return;
+
+    write(RecordType::EventRecord);
+    write(evt);
+}
+
+void TraceRecorder::recordMessage(const xy::Message& msg)
+{
+    if (!recording || !frameStarted) return;
+
+    XY_ASSERT(msg.m_dataSize <= std::numeric_limits<sf::Uint8>::max(), "Message too large to record");
+
+    write(RecordType::MessageRecord);
+    write(msg.id);
+    write(static_cast<sf::Uint8>(msg.m_dataSize));
+
+    const auto* bytes = static_cast<const char*>(msg.m_data);
+    activeBuffer->insert(activeBuffer->end(), bytes, bytes + msg.m_dataSize);
+}
+
+//------trace player------//
+TracePlayer::TracePlayer()
+    : m_readOffset  (0),
+    m_frameCount    (0),
+    m_frame         (0),
+    m_frameTime     (0.f)
+{
+
+}
+
+//public
+bool TracePlayer::loadFromFile(const std::string& path)
+{
+    m_data.clear();
+    m_readOffset = 0;
+    m_frameCount = 0;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open() || !file.good())
+    {
+        Logger::log("Failed opening trace " + path, Logger::Type::Error);
+        return false;
+    }
+
+    m_data.resize(static_cast<std::size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(m_data.data(), m_data.size());
+
+    char magic[sizeof(Magic)];
+    sf::Uint32 version = 0;
+    sf::Uint32 eventSize = 0;
+    if (!read(magic) || !read(version) || !read(eventSize)
+        || std::memcmp(magic, Magic, sizeof(Magic)) != 0)
+    {
+        Logger::log(path + ": not a valid trace file", Logger::Type::Error);
+        m_data.clear();
+        return false;
+    }
+
+    if (version != Version || eventSize != sizeof(sf::Event))
+    {
+        Logger::log(path + ": trace was recorded with an incompatible version", Logger::Type::Error);
+        m_data.clear();
+        return false;
+    }
+
+    //count the frames, checking the records are complete while we're at it
+    const auto start = m_readOffset;
+    while (m_readOffset < m_data.size())
+    {
+        //any read which fails, or a record of unknown size, marks the trace as corrupt
+        auto type = static_cast<RecordType>(0xff);
+        read(type);
+
+        std::size_t size = m_data.size();
+        switch (type)
+        {
+        case RecordType::FrameRecord:
+            size = sizeof(sf::Uint32) + sizeof(float);
+            m_frameCount++;
+            break;
+        case RecordType::EventRecord:
+            if (m_frameCount != 0) //events must belong to a frame
+            {
+                size = sizeof(sf::Event);
+            }
+            break;
+        case RecordType::MessageRecord:
+        {
+            Message::ID id = 0;
+            sf::Uint8 dataSize = 0;
+            if (m_frameCount != 0
+                && read(id) && read(dataSize))
+            {
+                size = dataSize;
+            }
+        }
+            break;
+        default:
+            break;
+        }
+
+        if (m_readOffset + size > m_data.size())
+        {
+            Logger::log(path + ": trace is truncated or corrupt", Logger::Type::Error);
+            m_data.clear();
+            m_frameCount = 0;
+            m_readOffset = 0;
+            return false;
+        }
+        m_readOffset += size;
+    }
+
+    //remove the header so rewinding starts at the first frame
+    m_data.erase(m_data.begin(), m_data.begin() + start);
+    m_readOffset = 0;
+    return true;
+}
+
+bool TracePlayer::nextFrame()
+{
+    if (m_readOffset == m_data.size())
+    {
+        return false;
+    }
+
+    //records are checked when the trace is loaded, so these
+    //reads should only fail if the trace has been corrupted since
+    RecordType type;
+    if (!read(type) || type != RecordType::FrameRecord
+        || !read(m_frame) || !read(m_frameTime))
+    {
+        Logger::log("Trace frame is truncated or corrupt", Logger::Type::Error);
+        m_readOffset = m_data.size();
+        return false;
+    }
+
+    alignas(std::max_align_t) char messageData[256];
+    while (m_readOffset < m_data.size()
+        && m_data[m_readOffset] != RecordType::FrameRecord)
+    {
+        read(type);
+        if (type == RecordType::EventRecord)
+        {
+            sf::Event evt;
+            if (!read(evt))
+            {
+                Logger::log("Trace event is truncated", Logger::Type::Error);
+                m_readOffset = m_data.size();
+                break;
+            }
+            if (m_eventHandler)
+            {
+                m_eventHandler(evt);
+            }
+        }
+        else
+        {
+            xy::Message msg;
+            sf::Uint8 size = 0;
+            if (!read(msg.id) || !read(size)
+                || m_readOffset + size > m_data.size())
+            {
+                Logger::log("Trace message is truncated", Logger::Type::Error);
+                m_readOffset = m_data.size();
+                break;
+            }
+
+            //copied so that the message data is correctly aligned
+            std::memcpy(messageData, m_data.data() + m_readOffset, size);
+            m_readOffset += size;
+
+            msg.m_data = messageData;
+            msg.m_dataSize = size;
+            if (m_messageHandler)
+            {
+                m_messageHandler(msg);
+            }
+        }
+    }
+    return true;
+}
+
+void TracePlayer::rewind()
+{
+    m_readOffset = 0;
+    m_frame = 0;
+    m_frameTime = 0.f;
+}
+
+//private
+template <typename T>
+bool TracePlayer::read(T& value)
+{
+    if (m_readOffset + sizeof(T) > m_data.size())
+    {
+        return false;
+    }
+    std::memcpy(&value, m_data.data() + m_readOffset, sizeof(T));
+    m_readOffset += sizeof(T);
+    return true;
+}
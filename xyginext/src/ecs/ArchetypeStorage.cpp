@@ -0,0 +1,332 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/ecs/ArchetypeStorage.hpp>
+#include <xyginext/ecs/Entity.hpp>
+
+using namespace xy;
+using namespace xy::Detail;
+
+constexpr std::size_t ArchetypeColumn::ChunkShift;
+constexpr std::size_t ArchetypeColumn::ChunkSize;
+constexpr std::size_t ArchetypeColumn::ChunkMask;
+constexpr std::uint8_t ArchetypeTable::NoColumn;
+constexpr std::uint32_t ArchetypeTable::NoEntity;
+
+ArchetypeTable::ArchetypeTable(const ComponentMask& mask)
+    : m_mask(mask)
+{
+    m_columnIndices.fill(NoColumn);
+}
+
+ArchetypeStorage::ArchetypeStorage()
+    : m_lastTable   (nullptr),
+    m_placement     (nullptr)
+{
+    m_pools.fill(nullptr);
+}
+
+//public
+void ArchetypeStorage::addPool(Component::ID id, StagedPool& pool)
+{
+    XY_ASSERT(id < MaxComponents, "Component index out of range");
+    m_pools[id] = &pool;
+    m_groupedMask.set(id);
+
+    //pools are created by the first component of their type, which
+    //may be part way through placing the entities of a prefab
+    if (m_placementMask[id])
+    {
+        setPlacement();
+    }
+}
+
+ArchetypeStorage::~ArchetypeStorage()
+{
+    //columns only destroy the components in rows which are still in use
+    compact();
+}
+
+void ArchetypeStorage::resize(std::size_t entityCount)
+{
+    if (entityCount > m_locations.size())
+    {
+        m_locations.resize(entityCount);
+    }
+}
+
+void ArchetypeStorage::update(std::size_t entity, const ComponentMask& mask)
+{
+    const auto grouped = mask & m_groupedMask;
+    if (entity >= m_locations.size())
+    {
+        if (grouped.none())
+        {
+            return;
+        }
+        m_locations.resize(entity + 1);
+    }
+
+    auto* src = m_locations[entity].table;
+    const auto srcRow = m_locations[entity].row;
+
+    if (grouped.none())
+    {
+        if (src)
+        {
+            removeRow(*src, srcRow);
+            m_locations[entity].table = nullptr;
+        }
+        return;
+    }
+
+    auto& dst = getTable(mask);
+    if (&dst == src)
+    {
+        //only components which were removed and added again need moving
+        for (auto i = 0u; i < dst.m_columns.size(); ++i)
+        {
+            if (m_pools[dst.m_columnIDs[i]]->isStaged(entity))
+            {
+                dst.m_columns[i]->replaceStaged(entity, srcRow);
+            }
+        }
+        return;
+    }
+
+    const auto row = static_cast<std::uint32_t>(dst.m_entities.size());
+    dst.m_entities.push_back(static_cast<std::uint32_t>(entity));
+    for (auto i = 0u; i < dst.m_columns.size(); ++i)
+    {
+        const auto id = dst.m_columnIDs[i];
+        auto& column = *dst.m_columns[i];
+
+        if (m_pools[id]->isStaged(entity))
+        {
+            column.pushStaged(entity);
+        }
+        else
+        {
+            XY_ASSERT(src && src->m_columnIndices[id] != ArchetypeTable::NoColumn, "Component is neither staged nor in a table");
+            column.pushFrom(*src->m_columns[src->m_columnIndices[id]], srcRow, entity);
+        }
+    }
+
+    if (src)
+    {
+        removeRow(*src, srcRow);
+    }
+    m_locations[entity].table = &dst;
+    m_locations[entity].row = row;
+}
+
+void ArchetypeStorage::compact()
+{
+    for (auto* table : m_uncompactedTables)
+    {
+        auto& entities = table->m_entities;
+        for (auto row : table->m_removedRows)
+        {
+            //removed rows at the end are dropped, then the last
+            //remaining row fills this one if it's still in the table
+            auto size = entities.size();
+            while (size != 0 && entities[size - 1] == ArchetypeTable::NoEntity)
+            {
+                size--;
+            }
+            if (size != entities.size())
+            {
+                for (auto& column : table->m_columns)
+                {
+                    column->truncate(size);
+                }
+                entities.resize(size);
+            }
+
+            if (row < entities.size())
+            {
+                const auto moved = entities.back();
+                for (auto& column : table->m_columns)
+                {
+                    column->fillRow(row, moved);
+                }
+                entities[row] = moved;
+                entities.pop_back();
+                m_locations[moved].row = row;
+            }
+        }
+        table->m_removedRows.clear();
+    }
+    m_uncompactedTables.clear();
+}
+
+bool ArchetypeStorage::hasStaged(const ComponentMask& mask) const
+{
+    const auto grouped = mask & m_groupedMask;
+    for (auto i = 0u; i < MaxComponents; ++i)
+    {
+        if (grouped[i] && m_pools[i]->getStagedCount() != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ArchetypeStorage::beginPlacement(const ComponentMask& mask)
+{
+    XY_ASSERT(m_placementMask.none(), "Entities are already being placed");
+    m_placementMask = mask;
+    if ((mask & m_groupedMask).any())
+    {
+        setPlacement();
+    }
+}
+
+void ArchetypeStorage::endPlacement(const std::vector<Entity>& entities)
+{
+    if (m_placement)
+    {
+        auto& table = *m_placement;
+        for (auto entity : entities)
+        {
+            const std::size_t index = entity.getIndex();
+            if (index >= m_locations.size())
+            {
+                m_locations.resize(index + 1);
+            }
+            XY_ASSERT(!m_locations[index].table, "Placed entities must not already be in a table");
+
+            m_locations[index].table = &table;
+            m_locations[index].row = static_cast<std::uint32_t>(table.m_entities.size());
+            table.m_entities.push_back(static_cast<std::uint32_t>(index));
+        }
+
+        for (auto i = 0u; i < table.m_columns.size(); ++i)
+        {
+            XY_ASSERT(table.m_columns[i]->size() == table.size(), "Every placed entity must have each grouped component in the mask");
+            m_pools[table.m_columnIDs[i]]->setPlacement(nullptr);
+        }
+    }
+    m_placement = nullptr;
+    m_placementMask.reset();
+}
+
+std::size_t ArchetypeStorage::getTables(const ComponentMask& mask, std::vector<const ArchetypeTable*>& dst) const
+{
+    XY_ASSERT(m_uncompactedTables.empty(), "Tables must be compacted before they are read");
+
+    std::size_t count = 0;
+    for (const auto& table : m_tables)
+    {
+        if (table->size() != 0
+            && (table->getMask() & mask) == mask)
+        {
+            dst.push_back(table.get());
+            count += table->size();
+        }
+    }
+    return count;
+}
+
+//private
+ArchetypeTable& ArchetypeStorage::getTable(const ComponentMask& mask)
+{
+    //entities are usually settled in batches with the same mask
+    if (m_lastTable && m_lastTable->m_mask == mask)
+    {
+        return *m_lastTable;
+    }
+
+    auto result = m_tableIndices.find(mask);
+    if (result != m_tableIndices.end())
+    {
+        m_lastTable = m_tables[result->second].get();
+        return *m_lastTable;
+    }
+
+    auto table = std::make_unique<ArchetypeTable>(mask);
+    const auto grouped = mask & m_groupedMask;
+    for (auto i = 0u; i < MaxComponents; ++i)
+    {
+        if (grouped[i])
+        {
+            addColumn(*table, i);
+        }
+    }
+
+    m_tableIndices.insert(std::make_pair(mask, m_tables.size()));
+    m_tables.push_back(std::move(table));
+    m_lastTable = m_tables.back().get();
+    return *m_lastTable;
+}
+
+void ArchetypeStorage::addColumn(ArchetypeTable& table, Component::ID id)
+{
+    table.m_columnIndices[id] = static_cast<std::uint8_t>(table.m_columns.size());
+    table.m_columns.push_back(m_pools[id]->createColumn());
+    table.m_columnIDs.push_back(id);
+}
+
+void ArchetypeStorage::setPlacement()
+{
+    m_placement = &getTable(m_placementMask);
+
+    //the table may have been created before the pools of some of
+    //its components, in which case it can't have any rows yet
+    for (auto i = 0u; i < MaxComponents; ++i)
+    {
+        if (m_placementMask[i] && m_pools[i]
+            && m_placement->m_columnIndices[i] == ArchetypeTable::NoColumn)
+        {
+            XY_ASSERT(m_placement->size() == 0, "Table is missing a column");
+            addColumn(*m_placement, i);
+        }
+    }
+
+    for (auto i = 0u; i < m_placement->m_columns.size(); ++i)
+    {
+        m_pools[m_placement->m_columnIDs[i]]->setPlacement(m_placement->m_columns[i].get());
+    }
+}
+
+void ArchetypeStorage::removeRow(ArchetypeTable& table, std::uint32_t row)
+{
+    //any components left behind are released now, while they're likely
+    //still in the cache, and the row is filled later by compact()
+    for (auto& column : table.m_columns)
+    {
+        column->destroyRow(row);
+    }
+
+    if (table.m_removedRows.empty())
+    {
+        m_uncompactedTables.push_back(&table);
+    }
+    table.m_removedRows.push_back(row);
+    table.m_entities[row] = ArchetypeTable::NoEntity;
+}
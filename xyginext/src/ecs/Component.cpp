@@ -28,15 +28,19 @@ source distribution.
 #include <xyginext/ecs/Component.hpp>
 #include <xyginext/ecs/Entity.hpp>
 
+#include <mutex>
+
 using namespace xy;
 
 namespace
 {
     std::vector<std::type_index> IDs;
+    std::mutex mutex;
 }
 
 Component::ID Component::getFromTypeID(std::type_index id)
 {
+    std::lock_guard<std::mutex> lock(mutex);
     XY_ASSERT(IDs.size() < Detail::MaxComponents, "Max components have been allocated");
 
     auto result = std::find(std::begin(IDs), std::end(IDs), id);
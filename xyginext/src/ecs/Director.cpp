@@ -28,12 +28,15 @@ source distribution.
 #include <xyginext/ecs/Director.hpp>
 #include <xyginext/ecs/systems/CommandSystem.hpp>
 
+#include <algorithm>
+
 using namespace xy;
 
 Director::Director()
     : m_messageBus(nullptr),
     m_commandSystem(nullptr),
-    m_scene(nullptr){}
+    m_scene(nullptr),
+    m_subscribesAll(false){}
 
 void Director::sendCommand(const Command& cmd)
 {
@@ -45,4 +48,20 @@ Scene& Director::getScene()
 {
     XY_ASSERT(m_scene, "Missing scene - are you using this correctly?");
     return *m_scene;
+}
+
+void Director::subscribe(Message::ID id)
+{
+    XY_ASSERT(!m_scene, "Directors must subscribe to messages in their constructor");
+    XY_ASSERT(id >= 0, "Invalid message ID");
+    if (std::find(m_subscriptions.begin(), m_subscriptions.end(), id) == m_subscriptions.end())
+    {
+        m_subscriptions.push_back(id);
+    }
+}
+
+void Director::subscribeAll()
+{
+    XY_ASSERT(!m_scene, "Directors must subscribe to messages in their constructor");
+    m_subscribesAll = true;
 }
\ No newline at end of file
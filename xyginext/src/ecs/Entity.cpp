@@ -32,12 +32,12 @@ using namespace xy;
 
 namespace
 {
-    const sf::Uint32 IndexMask = (1 << Detail::IndexBits) - 1;
-    const sf::Uint32 GenerationMask = (1 << Detail::GenerationBits) - 1;
+    const Entity::Handle IndexMask = (Entity::Handle(1) << Detail::IndexBits) - 1;
+    const Entity::Handle GenerationMask = (Entity::Handle(1) << Detail::GenerationBits) - 1;
 }
 
 Entity::Entity(Entity::ID index, Entity::Generation generation)
-    : m_id          ((generation << Detail::IndexBits) | index),
+    : m_id          ((Handle(generation) << Detail::IndexBits) | (index & IndexMask)),
     m_entityManager (nullptr)
 {
 
@@ -46,12 +46,12 @@ Entity::Entity(Entity::ID index, Entity::Generation generation)
 //public
 Entity::ID Entity::getIndex() const
 {
-    return m_id & IndexMask;
+    return static_cast<ID>(m_id & IndexMask);
 }
 
 Entity::Generation Entity::getGeneration() const
 {
-    return (m_id >> Detail::IndexBits) & GenerationMask;
+    return static_cast<Generation>((m_id >> Detail::IndexBits) & GenerationMask);
 }
 
 //TODO fix this so that it goes through its parent scene.
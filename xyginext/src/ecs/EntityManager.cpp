@@ -26,76 +26,304 @@ source distribution.
 *********************************************************************/
 
 #include <xyginext/ecs/Entity.hpp>
+#include <xyginext/ecs/Snapshot.hpp>
 #include <xyginext/core/Assert.hpp>
 #include <xyginext/core/MessageBus.hpp>
+#include <xyginext/core/Log.hpp>
+
+#include <cstring>
 
 using namespace xy;
 
+namespace xy
+{
+    namespace Detail
+    {
+        struct SnapshotPool final
+        {
+            Component::ID componentID = 0;
+            sf::Uint32 count = 0;
+            const char* indices = nullptr;
+            const char* data = nullptr;
+            std::size_t dataSize = 0;
+        };
+
+        //locations of each part of a snapshot's data
+        struct SnapshotLayout final
+        {
+            SnapshotHeader header;
+            const char* slots = nullptr;
+            std::vector<SnapshotPool> pools;
+            ComponentMask serialisable; //component types which are restored from the snapshot
+        };
+    }
+}
+
 namespace
 {
     const std::size_t MinComponentMasks = 50;
+
+    enum EntityFlags
+    {
+        Submitted = 0x1,
+        Changed = 0x2
+    };
+
+    const Entity::Handle IndexMask = (Entity::Handle(1) << Detail::IndexBits) - 1;
+
+    //the largest index is reserved to mark the end of the free list
+    const Entity::ID NullIndex = static_cast<Entity::ID>(IndexMask);
+    //slots are retired when they reach the largest generation
+    const Entity::Generation RetiredGeneration = static_cast<Entity::Generation>((Entity::Handle(1) << Detail::GenerationBits) - 1);
+
+    Entity::Handle makeSlot(Entity::ID index, Entity::Generation generation)
+    {
+        return Entity(index, generation).getHandle();
+    }
+
+    Entity::ID slotIndex(Entity::Handle slot)
+    {
+        return static_cast<Entity::ID>(slot & IndexMask);
+    }
+
+    Entity::Generation slotGeneration(Entity::Handle slot)
+    {
+        return static_cast<Entity::Generation>(slot >> Detail::IndexBits);
+    }
+
+    //slots in use hold their own index
+    bool slotLive(Entity::Handle slot, std::size_t index)
+    {
+        return slotIndex(slot) == index;
+    }
+
+    template <typename T>
+    void writeValue(std::vector<char>& dst, const T& value)
+    {
+        const auto* bytes = reinterpret_cast<const char*>(&value);
+        dst.insert(dst.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(const char*& src, const char* end, T& value)
+    {
+        if (static_cast<std::size_t>(end - src) < sizeof(T))
+        {
+            return false;
+        }
+        std::memcpy(&value, src, sizeof(T));
+        src += sizeof(T);
+        return true;
+    }
+
+    sf::Uint32 getIndex(const char* indices, std::size_t i)
+    {
+        sf::Uint32 index = 0;
+        std::memcpy(&index, indices + (i * sizeof(index)), sizeof(index));
+        return index;
+    }
+
+    //must only be called while no other thread is marking changes, or
+    //under the change set's lock if no versions have been allocated yet
+    void resizeVersions(Detail::ChangeSet& changeSet, std::size_t size)
+    {
+        const auto count = changeSet.versionCount.load(std::memory_order_relaxed);
+        if (size <= count)
+        {
+            return;
+        }
+        size = std::max(size, count * 2);
+
+        std::unique_ptr<std::atomic<sf::Uint32>[]> versions(new std::atomic<sf::Uint32>[size]);
+        for (auto i = 0u; i < size; ++i)
+        {
+            versions[i].store(i < count ? changeSet.versions[i].load(std::memory_order_relaxed) : 0, std::memory_order_relaxed);
+        }
+        changeSet.versions = std::move(versions);
+        changeSet.versionCount.store(size, std::memory_order_release);
+    }
+
+    //sets the entity's version, returning true if it wasn't already
+    //marked in this version, so only one thread appends the entity
+    bool claimVersion(Detail::ChangeSet& changeSet, std::size_t index, sf::Uint32 version)
+    {
+        auto& current = changeSet.versions[index];
+        auto last = current.load(std::memory_order_relaxed);
+        return last != version
+            && current.compare_exchange_strong(last, version, std::memory_order_relaxed);
+    }
+
+    Entity::Handle getSlot(const Detail::SnapshotLayout& layout, std::size_t i)
+    {
+        Entity::Handle slot = 0;
+        std::memcpy(&slot, layout.slots + (i * sizeof(slot)), sizeof(slot));
+        return slot;
+    }
+
+    //every slot must be live, on the free list or retired, and the free
+    //list must match the header, so that createEntity() only ever takes
+    //slots which are free, and which are within the restored slot array
+    bool validateSlots(const Detail::SnapshotLayout& layout)
+    {
+        const auto& header = layout.header;
+        if (header.slotCount > NullIndex
+            || header.freeCount > header.slotCount
+            || header.retiredCount > header.slotCount - header.freeCount)
+        {
+            return false;
+        }
+
+        std::vector<bool> freeSlots(header.slotCount);
+        auto idx = header.freeHead;
+        for (auto i = 0u; i < header.freeCount; ++i)
+        {
+            if (idx >= header.slotCount || freeSlots[idx])
+            {
+                return false;
+            }
+
+            const auto slot = getSlot(layout, idx);
+            if (slotLive(slot, idx) || slotGeneration(slot) == RetiredGeneration)
+            {
+                return false;
+            }
+            freeSlots[idx] = true;
+
+            if (i + 1 == header.freeCount
+                && (idx != header.freeTail || slotIndex(slot) != NullIndex))
+            {
+                return false;
+            }
+            idx = slotIndex(slot);
+        }
+
+        std::size_t retiredCount = 0;
+        for (auto i = 0u; i < header.slotCount; ++i)
+        {
+            const auto slot = getSlot(layout, i);
+            if (slot == makeSlot(NullIndex, RetiredGeneration))
+            {
+                retiredCount++;
+            }
+            else if (!freeSlots[i]
+                && (!slotLive(slot, i) || slotGeneration(slot) == RetiredGeneration))
+            {
+                return false;
+            }
+        }
+        return retiredCount == header.retiredCount;
+    }
 }
 
 EntityManager::EntityManager(MessageBus& mb)
     : m_messageBus  (mb),
-    m_componentPools(Detail::MaxComponents)
-{}
+    m_freeHead      (NullIndex),
+    m_freeTail      (NullIndex),
+    m_freeCount     (0),
+    m_retiredCount  (0),
+    m_componentPools(Detail::MaxComponents),
+    m_serialisers   (Detail::MaxComponents),
+    m_version       (1)
+{
+    //created up front so that marking changes from multiple threads never resizes the list
+    m_changeSets.reserve(Detail::MaxComponents);
+    for (auto i = 0u; i < Detail::MaxComponents; ++i)
+    {
+        m_changeSets.emplace_back(std::make_unique<Detail::ChangeSet>());
+    }
+}
 
 //public
 Entity EntityManager::createEntity()
 {
     Entity::ID idx;
-    if (m_freeIDs.size() > Detail::MinFreeIDs)
+    if (m_freeCount > Detail::MinFreeIDs)
     {
-        idx = m_freeIDs.front();
-        m_freeIDs.pop_front();
+        //take the oldest free slot, which already holds its next generation
+        idx = m_freeHead;
+        m_freeHead = slotIndex(m_slots[idx]);
+        m_freeCount--;
+
+        m_slots[idx] = makeSlot(idx, slotGeneration(m_slots[idx]));
     }
     else
     {
-        m_generations.push_back(0);
-        idx = static_cast<Entity::ID>(m_generations.size() - 1);
-        
-        XY_ASSERT(idx < (1 << Detail::IndexBits), "Index out of range");
+        idx = static_cast<Entity::ID>(m_slots.size());
+        XY_ASSERT(idx < NullIndex, "Index out of range");
+
+        m_slots.push_back(makeSlot(idx, 0));
         if (idx >= m_componentMasks.size())
         {
             m_componentMasks.resize(m_componentMasks.size() + MinComponentMasks);
+            m_removalMasks.resize(m_componentMasks.size());
+            m_entityFlags.resize(m_componentMasks.size());
+            m_archetypes.resize(m_componentMasks.size());
+            resizeChangeSets();
         }
     }
 
-    XY_ASSERT(idx < m_generations.size(), "Index out of range");
-    Entity e(idx, m_generations[idx]);
+    Entity e(idx, slotGeneration(m_slots[idx]));
     e.m_entityManager = this;
 
     return e;
 }
 
-void EntityManager::destroyEntity(Entity entity)
+std::vector<Entity> EntityManager::createEntities(std::size_t count)
 {
-    const auto index = entity.getIndex();
-    XY_ASSERT(index < m_generations.size(), "Index out of range");
+    //work out how many new IDs are needed so storage is only resized once
+    const std::size_t recycled = (m_freeCount > Detail::MinFreeIDs) ?
+        std::min(count, m_freeCount - Detail::MinFreeIDs) : 0;
+    const auto newSize = m_slots.size() + (count - recycled);
 
-    ++m_generations[index];
-    m_freeIDs.push_back(index);
-    m_componentMasks[index].reset();
+    m_slots.reserve(newSize);
+    if (newSize > m_componentMasks.size())
+    {
+        m_componentMasks.resize(newSize + MinComponentMasks);
+        m_removalMasks.resize(m_componentMasks.size());
+        m_entityFlags.resize(m_componentMasks.size());
+        m_archetypes.resize(m_componentMasks.size());
+        resizeChangeSets();
+    }
 
-    //let the world know the entity was destroyed
-    auto msg = m_messageBus.post<Message::SceneEvent>(Message::SceneMessage);
-    msg->entityID = index;
-    msg->event = Message::SceneEvent::EntityDestroyed;
+    std::vector<Entity> entities;
+    entities.reserve(count);
+    for (auto i = 0u; i < count; ++i)
+    {
+        entities.push_back(createEntity());
+    }
+    return entities;
+}
+
+void EntityManager::destroyEntity(Entity entity)
+{
+    destroy(entity);
+    m_archetypes.compact();
+}
+
+void EntityManager::destroyEntities(const std::vector<Entity>& entities)
+{
+    for (auto entity : entities)
+    {
+        //the same entity may have been queued more than once
+        if (!entityDestroyed(entity))
+        {
+            destroy(entity);
+        }
+    }
+    m_archetypes.compact();
 }
 
 bool EntityManager::entityDestroyed(Entity entity) const
 {
     const auto id = entity.getIndex();
-    XY_ASSERT(id < m_generations.size(), "Generation index out of range");
-    
-    return (m_generations[id] != entity.getGeneration());
+    //indices beyond the end may have been removed by restoring a snapshot
+    return (id >= m_slots.size() || slotGeneration(m_slots[id]) != entity.getGeneration());
 }
 
 Entity EntityManager::getEntity(Entity::ID id) const
 {
-    XY_ASSERT(id < m_generations.size(), "Invalid Entity ID");
-    Entity ent(id, m_generations[id]);
+    XY_ASSERT(id < m_slots.size(), "Invalid Entity ID");
+    Entity ent(id, slotGeneration(m_slots[id]));
     ent.m_entityManager = const_cast<EntityManager*>(this);
     return ent;
 }
@@ -110,4 +338,606 @@ const ComponentMask& EntityManager::getComponentMask(Entity entity) const
 bool EntityManager::owns(Entity entity) const
 {
     return (entity.m_entityManager == this);
-}
\ No newline at end of file
+}
+
+void EntityManager::setSubmitted(Entity entity)
+{
+    const auto index = entity.getIndex();
+    XY_ASSERT(index < m_entityFlags.size(), "Index out of range");
+    m_entityFlags[index] |= Submitted;
+
+    //components added before submission are staged until now
+    m_archetypes.update(index, m_componentMasks[index]);
+    m_archetypes.compact();
+}
+
+ComponentMask EntityManager::getPendingMask(Entity entity) const
+{
+    const auto index = entity.getIndex();
+    XY_ASSERT(index < m_componentMasks.size(), "Invalid mask index (out of range)");
+    return m_componentMasks[index] & ~m_removalMasks[index];
+}
+
+void EntityManager::applyChanges()
+{
+    for (auto entity : m_changedEntities)
+    {
+        //entity was destroyed, and the index possibly reused, since it was marked
+        const auto index = entity.getIndex();
+        if (slotGeneration(m_slots[index]) != entity.getGeneration())
+        {
+            continue;
+        }
+
+        m_entityFlags[index] &= ~Changed;
+
+        auto& removals = m_removalMasks[index];
+        if (removals.any())
+        {
+            for (auto i = 0u; i < Detail::MaxComponents; ++i)
+            {
+                if (removals[i])
+                {
+                    if (m_componentPools[i])
+                    {
+                        m_componentPools[i]->remove(index);
+                    }
+                    m_componentMasks[index].reset(i);
+                }
+            }
+            removals.reset();
+        }
+        m_archetypes.update(index, m_componentMasks[index]);
+    }
+    m_archetypes.compact();
+    m_changedEntities.clear();
+}
+
+void EntityManager::markChanged(Entity entity, Component::ID componentID)
+{
+    XY_ASSERT(componentID < m_changeSets.size(), "Component index out of range");
+    const auto index = entity.getIndex();
+    entity.m_entityManager = this;
+
+    //most calls find the entity already marked in this version, so the
+    //lock is only taken when the entity actually needs appending
+    auto& changeSet = *m_changeSets[componentID];
+    if (index >= changeSet.versionCount.load(std::memory_order_acquire))
+    {
+        //versions are allocated the first time a component type is marked,
+        //and are then resized along with the slots
+        std::lock_guard<std::mutex> lock(changeSet.mutex);
+        if (changeSet.versionCount.load(std::memory_order_relaxed) == 0)
+        {
+            resizeVersions(changeSet, m_componentMasks.size());
+        }
+        XY_ASSERT(index < changeSet.versionCount.load(std::memory_order_relaxed), "Change set has not been resized");
+    }
+
+    if (claimVersion(changeSet, index, m_version))
+    {
+        std::lock_guard<std::mutex> lock(changeSet.mutex);
+        changeSet.current.push_back(entity);
+    }
+}
+
+void EntityManager::markChanged(const std::vector<Entity>& entities, Component::ID componentID)
+{
+    XY_ASSERT(componentID < m_changeSets.size(), "Component index out of range");
+
+    auto& changeSet = *m_changeSets[componentID];
+    std::lock_guard<std::mutex> lock(changeSet.mutex);
+    if (changeSet.versionCount.load(std::memory_order_relaxed) == 0)
+    {
+        resizeVersions(changeSet, m_componentMasks.size());
+    }
+
+    for (auto entity : entities)
+    {
+        if (claimVersion(changeSet, entity.getIndex(), m_version))
+        {
+            entity.m_entityManager = this;
+            changeSet.current.push_back(entity);
+        }
+    }
+}
+
+bool EntityManager::getChanged(Component::ID componentID, sf::Uint32 sinceVersion, std::vector<Entity>& dst) const
+{
+    XY_ASSERT(componentID < m_changeSets.size(), "Component index out of range");
+
+    auto& changeSet = *m_changeSets[componentID];
+    std::lock_guard<std::mutex> lock(changeSet.mutex);
+
+    auto valid = [&](Entity entity)
+    {
+        const auto index = entity.getIndex();
+        return slotGeneration(m_slots[index]) == entity.getGeneration()
+            && m_componentMasks[index][componentID];
+    };
+
+    if (sinceVersion < m_version)
+    {
+        for (auto entity : changeSet.previous)
+        {
+            //entities marked again in this version appear in the current list
+            if (changeSet.versions[entity.getIndex()].load(std::memory_order_relaxed) == m_version - 1
+                && valid(entity))
+            {
+                dst.push_back(entity);
+            }
+        }
+    }
+
+    for (auto entity : changeSet.current)
+    {
+        if (valid(entity))
+        {
+            dst.push_back(entity);
+        }
+    }
+
+    return (sinceVersion + 1 >= m_version);
+}
+
+void EntityManager::nextVersion()
+{
+    for (auto& changeSet : m_changeSets)
+    {
+        changeSet->previous.swap(changeSet->current);
+        changeSet->current.clear();
+    }
+    m_version++;
+}
+
+void EntityManager::createSnapshot(Snapshot& snapshot) const
+{
+    auto& dst = snapshot.m_data;
+    dst.clear();
+    snapshot.m_verified.set(); //written by this build, so can be read back
+
+    std::vector<Component::ID> pools;
+    for (auto i = 0u; i < m_serialisers.size(); ++i)
+    {
+        if (m_serialisers[i])
+        {
+            pools.push_back(i);
+        }
+    }
+
+    Detail::SnapshotHeader header;
+    header.magic = Detail::SnapshotHeader::Magic;
+    header.version = Detail::SnapshotHeader::CurrentVersion;
+    header.handleSize = sizeof(Entity::Handle);
+    header.slotCount = static_cast<sf::Uint32>(m_slots.size());
+    header.freeHead = m_freeHead;
+    header.freeTail = m_freeTail;
+    header.poolCount = static_cast<sf::Uint32>(pools.size());
+    header.freeCount = m_freeCount;
+    header.retiredCount = m_retiredCount;
+
+    writeValue(dst, header);
+    const auto* slots = reinterpret_cast<const char*>(m_slots.data());
+    dst.insert(dst.end(), slots, slots + (m_slots.size() * sizeof(Entity::Handle)));
+
+    std::vector<sf::Uint32> indices;
+    for (auto id : pools)
+    {
+        indices.clear();
+        for (auto i = 0u; i < m_slots.size(); ++i)
+        {
+            if (m_componentMasks[i][id] && slotLive(m_slots[i], i))
+            {
+                indices.push_back(i);
+            }
+        }
+
+        const auto* name = m_serialisers[id]->getName();
+        const auto nameLength = static_cast<sf::Uint32>(std::strlen(name));
+        writeValue(dst, nameLength);
+        dst.insert(dst.end(), name, name + nameLength);
+
+        writeValue(dst, static_cast<sf::Uint32>(indices.size()));
+        const auto* indexData = reinterpret_cast<const char*>(indices.data());
+        dst.insert(dst.end(), indexData, indexData + (indices.size() * sizeof(sf::Uint32)));
+
+        //size of the component data is written up front so unknown pools can be skipped
+        const auto sizePosition = dst.size();
+        writeValue(dst, sf::Uint64(0));
+        for (auto index : indices)
+        {
+            m_serialisers[id]->write(index, dst);
+        }
+        const sf::Uint64 dataSize = dst.size() - sizePosition - sizeof(sf::Uint64);
+        std::memcpy(&dst[sizePosition], &dataSize, sizeof(dataSize));
+    }
+}
+
+bool EntityManager::getSnapshotChanges(const Snapshot& snapshot, std::vector<Entity>& dst) const
+{
+    Detail::SnapshotLayout layout;
+    if (!readLayout(snapshot, layout))
+    {
+        return false;
+    }
+
+    std::vector<ComponentMask> masks;
+    getSnapshotMasks(layout, masks);
+
+    for (auto i = 0u; i < m_slots.size(); ++i)
+    {
+        if (slotLive(m_slots[i], i)
+            && (i >= masks.size() || getSlot(layout, i) != m_slots[i] || masks[i] != m_componentMasks[i]))
+        {
+            dst.push_back(getEntity(i));
+        }
+    }
+    return true;
+}
+
+bool EntityManager::restoreSnapshot(const Snapshot& snapshot, std::vector<Entity>& dst)
+{
+    Detail::SnapshotLayout layout;
+    if (!readLayout(snapshot, layout))
+    {
+        return false;
+    }
+
+    std::vector<ComponentMask> masks;
+    getSnapshotMasks(layout, masks);
+
+    //entities which are alive both now and in the snapshot
+    const std::size_t slotCount = layout.header.slotCount;
+    std::vector<bool> sameEntity(slotCount);
+    for (auto i = 0u; i < slotCount && i < m_slots.size(); ++i)
+    {
+        sameEntity[i] = slotLive(m_slots[i], i) && getSlot(layout, i) == m_slots[i];
+    }
+
+    //release components which won't exist once the snapshot is restored
+    for (auto i = 0u; i < m_slots.size(); ++i)
+    {
+        if (slotLive(m_slots[i], i))
+        {
+            auto removed = m_componentMasks[i];
+            if (i < slotCount && sameEntity[i])
+            {
+                removed &= ~masks[i];
+            }
+
+            for (auto j = 0u; j < Detail::MaxComponents; ++j)
+            {
+                if (removed[j])
+                {
+                    releaseComponent(i, j);
+                }
+            }
+        }
+    }
+
+    m_slots.resize(slotCount);
+    if (slotCount > 0)
+    {
+        std::memcpy(m_slots.data(), layout.slots, slotCount * sizeof(Entity::Handle));
+    }
+    m_freeHead = layout.header.freeHead;
+    m_freeTail = layout.header.freeTail;
+    m_freeCount = static_cast<std::size_t>(layout.header.freeCount);
+    m_retiredCount = static_cast<std::size_t>(layout.header.retiredCount);
+
+    if (slotCount > m_componentMasks.size())
+    {
+        m_componentMasks.resize(slotCount + MinComponentMasks);
+        m_removalMasks.resize(m_componentMasks.size());
+        m_entityFlags.resize(m_componentMasks.size());
+        m_archetypes.resize(m_componentMasks.size());
+        resizeChangeSets();
+    }
+
+    //components are read while the masks still show which already
+    //exist, so that existing components are updated in place
+    for (const auto& pool : layout.pools)
+    {
+        auto& serialiser = *m_serialisers[pool.componentID];
+        serialiser.prepare(slotCount);
+
+        const bool tracked = serialiser.tracksChanges();
+        SnapshotReader src(pool.data, pool.dataSize, slotCount);
+        for (auto i = 0u; i < pool.count; ++i)
+        {
+            const auto index = getIndex(pool.indices, i);
+            if (!serialiser.read(index, src, sameEntity[index] && m_componentMasks[index][pool.componentID]))
+            {
+                //the data has already been verified, so this only happens if a
+                //serialiser's read() gives a different result for the same data
+                Logger::log("Failed reading verified snapshot data for " + std::string(serialiser.getName()), Logger::Type::Error);
+                break;
+            }
+
+            if (tracked)
+            {
+                markChanged(getEntity(index), pool.componentID);
+            }
+        }
+    }
+
+    for (auto i = 0u; i < m_componentMasks.size(); ++i)
+    {
+        if (i < slotCount && slotLive(m_slots[i], i))
+        {
+            if (!sameEntity[i])
+            {
+                m_entityFlags[i] = Submitted;
+                m_componentMasks[i] = masks[i];
+                dst.push_back(getEntity(i));
+            }
+            else if (masks[i] != m_componentMasks[i])
+            {
+                m_componentMasks[i] = masks[i];
+                dst.push_back(getEntity(i));
+            }
+        }
+        else
+        {
+            m_componentMasks[i].reset();
+            m_entityFlags[i] = 0;
+        }
+        m_removalMasks[i].reset();
+        m_archetypes.update(i, m_componentMasks[i]);
+    }
+    m_archetypes.compact();
+
+    return true;
+}
+
+//private
+void EntityManager::queueChanged(Entity::ID index)
+{
+    //added components only matter once the entity is in systems, as until
+    //then it will be submitted with its complete mask. Removals always need
+    //applying, even if the entity is still waiting to be submitted.
+    if ((m_entityFlags[index] & Changed) == 0
+        && ((m_entityFlags[index] & Submitted) || m_removalMasks[index].any()))
+    {
+        m_entityFlags[index] |= Changed;
+        m_changedEntities.push_back(getEntity(index));
+    }
+}
+
+void EntityManager::destroy(Entity entity)
+{
+    const auto index = entity.getIndex();
+    XY_ASSERT(index < m_slots.size(), "Index out of range");
+
+    const auto generation = slotGeneration(m_slots[index]);
+    XY_ASSERT(generation == entity.getGeneration(), "Entity already destroyed");
+
+    if (generation + 1 == RetiredGeneration)
+    {
+        //rather than wrap around, which would let stale
+        //handles alias a new entity, the slot is never reused
+        m_slots[index] = makeSlot(NullIndex, RetiredGeneration);
+        m_retiredCount++;
+    }
+    else
+    {
+        //append to the end of the free list
+        m_slots[index] = makeSlot(NullIndex, generation + 1);
+        if (m_freeCount == 0)
+        {
+            m_freeHead = index;
+        }
+        else
+        {
+            m_slots[m_freeTail] = makeSlot(index, slotGeneration(m_slots[m_freeTail]));
+        }
+        m_freeTail = index;
+        m_freeCount++;
+    }
+
+    //let any pools which need to know release the components
+    const auto& mask = m_componentMasks[index];
+    for (auto i = 0u; i < Detail::MaxComponents; ++i)
+    {
+        if (mask[i])
+        {
+            releaseComponent(index, i);
+        }
+    }
+    m_componentMasks[index].reset();
+    m_removalMasks[index].reset();
+    m_entityFlags[index] = 0;
+    m_archetypes.update(index, m_componentMasks[index]);
+
+    //let the world know the entity was destroyed
+    auto msg = m_messageBus.post<Message::SceneEvent>(Message::SceneMessage);
+    msg->entityID = index;
+    msg->event = Message::SceneEvent::EntityDestroyed;
+}
+
+void EntityManager::releaseComponent(Entity::ID index, Component::ID componentID)
+{
+    if (m_componentPools[componentID])
+    {
+        m_componentPools[componentID]->remove(index);
+    }
+
+    //so a new entity using this index is not mistaken for one already marked
+    auto& changeSet = *m_changeSets[componentID];
+    if (index < changeSet.versionCount.load(std::memory_order_relaxed))
+    {
+        changeSet.versions[index].store(0, std::memory_order_relaxed);
+    }
+}
+
+void EntityManager::resizeChangeSets()
+{
+    //only change sets which have been used are allocated, and they are
+    //resized here with the slots so that they never need resizing while
+    //systems mark changes from other threads
+    for (auto& changeSet : m_changeSets)
+    {
+        if (changeSet->versionCount.load(std::memory_order_relaxed) != 0)
+        {
+            resizeVersions(*changeSet, m_componentMasks.size());
+        }
+    }
+}
+
+void EntityManager::beginPlacement(const std::vector<Entity>& entities, const ComponentMask& mask)
+{
+    for (auto entity : entities)
+    {
+        if (m_componentMasks[entity.getIndex()].any())
+        {
+            return;
+        }
+    }
+    m_archetypes.beginPlacement(mask);
+}
+
+void EntityManager::endPlacement(const std::vector<Entity>& entities)
+{
+    m_archetypes.endPlacement(entities);
+}
+
+bool EntityManager::readLayout(const Snapshot& snapshot, Detail::SnapshotLayout& layout) const
+{
+    if (!snapshot.isValid())
+    {
+        Logger::log("Invalid snapshot data", Logger::Type::Error);
+        return false;
+    }
+
+    const auto& data = snapshot.getData();
+    const char* src = data.data();
+    const char* end = src + data.size();
+
+    readValue(src, end, layout.header);
+    layout.slots = src;
+    src += layout.header.slotCount * sizeof(Entity::Handle);
+
+    if (!validateSlots(layout))
+    {
+        Logger::log("Snapshot contains invalid entity slots", Logger::Type::Error);
+        return false;
+    }
+
+    for (auto& serialiser : m_serialisers)
+    {
+        if (serialiser)
+        {
+            layout.serialisable.set(&serialiser - m_serialisers.data());
+        }
+    }
+
+    ComponentMask verified;
+    for (auto i = 0u; i < layout.header.poolCount; ++i)
+    {
+        sf::Uint32 nameLength = 0;
+        if (!readValue(src, end, nameLength)
+            || static_cast<std::size_t>(end - src) < nameLength)
+        {
+            Logger::log("Snapshot data is truncated", Logger::Type::Error);
+            return false;
+        }
+        std::string name(src, nameLength);
+        src += nameLength;
+
+        Detail::SnapshotPool pool;
+        sf::Uint64 dataSize = 0;
+        if (!readValue(src, end, pool.count)
+            || static_cast<std::size_t>(end - src) < pool.count * sizeof(sf::Uint32))
+        {
+            Logger::log("Snapshot data is truncated", Logger::Type::Error);
+            return false;
+        }
+        pool.indices = src;
+        src += pool.count * sizeof(sf::Uint32);
+
+        if (!readValue(src, end, dataSize)
+            || static_cast<sf::Uint64>(end - src) < dataSize)
+        {
+            Logger::log("Snapshot data is truncated", Logger::Type::Error);
+            return false;
+        }
+        pool.data = src;
+        pool.dataSize = static_cast<std::size_t>(dataSize);
+        src += dataSize;
+
+        //match the pool to a component type by name
+        auto result = std::find_if(m_serialisers.begin(), m_serialisers.end(),
+            [&name](const std::unique_ptr<Detail::PoolSerialiser>& s)
+        {
+            return s && name == s->getName();
+        });
+
+        if (result == m_serialisers.end())
+        {
+            Logger::log("Snapshot contains unknown component " + name + ", which will be skipped", Logger::Type::Warning);
+            continue;
+        }
+        pool.componentID = static_cast<Component::ID>(std::distance(m_serialisers.begin(), result));
+        if (std::any_of(layout.pools.begin(), layout.pools.end(),
+            [&pool](const Detail::SnapshotPool& p) { return p.componentID == pool.componentID; }))
+        {
+            Logger::log("Snapshot contains component " + name + " more than once", Logger::Type::Error);
+            return false;
+        }
+
+        //indices are written in ascending order, and only for live entities,
+        //so that each entity has at most one of each component
+        std::vector<sf::Uint32> entities(pool.count);
+        for (auto j = 0u; j < pool.count; ++j)
+        {
+            entities[j] = getIndex(pool.indices, j);
+            if (entities[j] >= layout.header.slotCount
+                || (j > 0 && entities[j] <= entities[j - 1])
+                || !slotLive(getSlot(layout, entities[j]), entities[j]))
+            {
+                Logger::log("Snapshot contains invalid entity index", Logger::Type::Error);
+                return false;
+            }
+        }
+
+        //components are read in full once before they are restored, so that
+        //an invalid snapshot is rejected before anything is changed. Only
+        //data which hasn't been created by this build needs checking.
+        if (!snapshot.m_verified[pool.componentID])
+        {
+            SnapshotReader reader(pool.data, pool.dataSize, layout.header.slotCount);
+            if (!(*result)->validate(reader, entities) || reader.getRemaining() != 0)
+            {
+                Logger::log("Snapshot contains invalid data for component " + name, Logger::Type::Error);
+                return false;
+            }
+            verified.set(pool.componentID);
+        }
+        layout.pools.push_back(pool);
+    }
+
+    snapshot.m_verified |= verified;
+    return true;
+}
+
+void EntityManager::getSnapshotMasks(const Detail::SnapshotLayout& layout, std::vector<ComponentMask>& masks) const
+{
+    //components which can't be serialised are kept by entities which exist in both
+    masks.resize(layout.header.slotCount);
+    for (auto i = 0u; i < layout.header.slotCount; ++i)
+    {
+        const auto slot = getSlot(layout, i);
+        if (i < m_slots.size() && slotLive(slot, i) && slot == m_slots[i])
+        {
+            masks[i] = m_componentMasks[i] & ~layout.serialisable;
+        }
+    }
+
+    for (const auto& pool : layout.pools)
+    {
+        for (auto i = 0u; i < pool.count; ++i)
+        {
+            masks[getIndex(pool.indices, i)].set(pool.componentID);
+        }
+    }
+}
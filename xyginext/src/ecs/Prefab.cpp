@@ -0,0 +1,134 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/ecs/Prefab.hpp>
+#include <xyginext/ecs/components/Transform.hpp>
+#include <xyginext/core/Log.hpp>
+
+using namespace xy;
+
+namespace
+{
+    Transform loadTransform(const ConfigObject& obj)
+    {
+        Transform tx;
+        for (const auto& p : obj.getProperties())
+        {
+            const auto& name = p.getName();
+            if (name == "position")
+            {
+                tx.setPosition(p.getValue<sf::Vector2f>());
+            }
+            else if (name == "rotation")
+            {
+                tx.setRotation(p.getValue<float>());
+            }
+            else if (name == "scale")
+            {
+                tx.setScale(p.getValue<sf::Vector2f>());
+            }
+            else if (name == "origin")
+            {
+                tx.setOrigin(p.getValue<sf::Vector2f>());
+            }
+        }
+        return tx;
+    }
+}
+
+bool Prefab::loadFromFile(const std::string& path)
+{
+    ConfigFile file;
+    if (!file.loadFromFile(path))
+    {
+        Logger::log("Failed loading prefab " + path, Logger::Type::Error);
+        return false;
+    }
+
+    const auto& loaders = getLoaders();
+    for (const auto& obj : file.getObjects())
+    {
+        auto result = loaders.find(obj.getName());
+        if (result != loaders.end())
+        {
+            result->second(*this, obj);
+        }
+        else
+        {
+            Logger::log(path + ": no component registered with name " + obj.getName(), Logger::Type::Warning);
+        }
+    }
+    return true;
+}
+
+void Prefab::instantiate(EntityManager& entityManager, const std::vector<Entity>& entities) const
+{
+    if (entities.empty()) return;
+
+    //new entities are placed straight in the table for the prefab's
+    //mask, rather than staging their components until they're submitted
+    entityManager.beginPlacement(entities, m_componentMask);
+    for (const auto& component : m_components)
+    {
+        component->instantiate(entityManager, entities);
+    }
+    entityManager.endPlacement(entities);
+}
+
+//private
+std::unordered_map<std::string, Prefab::Loader>& Prefab::getLoaders()
+{
+    static std::unordered_map<std::string, Loader> loaders =
+    {
+        std::make_pair(std::string("transform"), Loader([](Prefab& prefab, const ConfigObject& obj)
+        {
+            prefab.addComponent<Transform>(loadTransform(obj));
+        }))
+    };
+    return loaders;
+}
+
+void Prefab::setPrototype(std::unique_ptr<Detail::ComponentPrototype> prototype)
+{
+    const auto id = prototype->getID();
+    m_componentMask.set(id);
+
+    auto result = std::find_if(m_components.begin(), m_components.end(),
+        [id](const std::unique_ptr<Detail::ComponentPrototype>& p)
+    {
+        return p->getID() == id;
+    });
+
+    if (result != m_components.end())
+    {
+        *result = std::move(prototype);
+    }
+    else
+    {
+        m_components.push_back(std::move(prototype));
+    }
+}
@@ -0,0 +1,206 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/ecs/Rollback.hpp>
+#include <xyginext/ecs/Scene.hpp>
+#include <xyginext/core/Assert.hpp>
+#include <xyginext/core/Log.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace xy;
+
+Rollback::Rollback(Scene& scene, std::size_t tickCount)
+    : m_scene       (scene),
+    m_ticks         (std::max(std::size_t(1), tickCount)),
+    m_tickCount     (0),
+    m_latestTick    (0),
+    m_changed       (false),
+    m_changedTick   (0)
+{
+
+}
+
+//public
+void Rollback::saveTick(Tick tick)
+{
+    if (m_tickCount > 0 && tick != m_latestTick + 1)
+    {
+        clear();
+    }
+
+    auto& state = getState(tick);
+    state.tick = tick;
+    state.inputs.clear();
+    m_scene.createSnapshot(state.snapshot);
+
+    m_latestTick = tick;
+    m_tickCount = std::min(m_tickCount + 1, m_ticks.size());
+}
+
+bool Rollback::recordInput(Tick tick, sf::Uint32 source, const void* data, std::size_t size)
+{
+    if (!hasTick(tick))
+    {
+        return false;
+    }
+
+    auto& inputs = getState(tick).inputs;
+    auto result = std::find_if(inputs.begin(), inputs.end(),
+        [source](const std::pair<sf::Uint32, std::vector<char>>& input)
+    {
+        return input.first == source;
+    });
+
+    const auto* bytes = static_cast<const char*>(data);
+    if (result == inputs.end())
+    {
+        inputs.emplace_back(source, std::vector<char>(bytes, bytes + size));
+    }
+    else if (result->second.size() != size
+        || std::memcmp(result->second.data(), bytes, size) != 0)
+    {
+        result->second.assign(bytes, bytes + size);
+    }
+    else
+    {
+        //same as the input already simulated
+        return true;
+    }
+
+    if (tick != m_latestTick)
+    {
+        if (!m_changed || tick < m_changedTick)
+        {
+            m_changedTick = tick;
+        }
+        m_changed = true;
+    }
+    return true;
+}
+
+const std::vector<char>* Rollback::getInput(Tick tick, sf::Uint32 source) const
+{
+    if (!hasTick(tick))
+    {
+        return nullptr;
+    }
+
+    for (const auto& input : getState(tick).inputs)
+    {
+        if (input.first == source)
+        {
+            return &input.second;
+        }
+    }
+    return nullptr;
+}
+
+bool Rollback::resimulate(Tick tick, float dt, const std::function<void()>& correction)
+{
+    if (!hasTick(tick))
+    {
+        return false;
+    }
+
+    if (!m_scene.restoreSnapshot(getState(tick).snapshot))
+    {
+        Logger::log("Failed restoring snapshot for tick " + std::to_string(tick), Logger::Type::Error);
+        return false;
+    }
+
+    if (correction)
+    {
+        correction();
+    }
+
+    //the latest tick is resimulated too, as it has already been simulated once
+    const auto count = m_latestTick - tick + 1;
+    for (auto i = 0u; i < count; ++i)
+    {
+        auto& state = getState(tick + i);
+        if (i > 0 || correction)
+        {
+            m_scene.createSnapshot(state.snapshot);
+        }
+
+        if (m_inputHandler)
+        {
+            for (const auto& input : state.inputs)
+            {
+                m_inputHandler(state.tick, input.first, input.second);
+            }
+        }
+        m_scene.resimulate(dt);
+    }
+
+    if (m_changed && m_changedTick >= tick)
+    {
+        m_changed = false;
+    }
+    return true;
+}
+
+bool Rollback::resimulateChanges(float dt)
+{
+    if (!m_changed)
+    {
+        return false;
+    }
+
+    if (!hasTick(m_changedTick))
+    {
+        Logger::log("Input changed for tick " + std::to_string(m_changedTick) + " which is no longer stored", Logger::Type::Warning);
+        m_changed = false;
+        return false;
+    }
+    return resimulate(m_changedTick, dt);
+}
+
+bool Rollback::hasTick(Tick tick) const
+{
+    return m_tickCount > 0
+        && tick <= m_latestTick
+        && m_latestTick - tick < m_tickCount;
+}
+
+Rollback::Tick Rollback::getOldestTick() const
+{
+    XY_ASSERT(m_tickCount > 0, "No ticks stored");
+    return m_latestTick - static_cast<Tick>(m_tickCount - 1);
+}
+
+void Rollback::clear()
+{
+    for (auto& state : m_ticks)
+    {
+        state.inputs.clear();
+    }
+    m_tickCount = 0;
+    m_changed = false;
+}
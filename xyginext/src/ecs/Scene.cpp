@@ -33,6 +33,8 @@ source distribution.
 
 #include <SFML/Window/Event.hpp>
 
+#include <algorithm>
+
 using namespace xy;
 
 namespace
@@ -57,8 +59,9 @@ namespace
 
 Scene::Scene(MessageBus& mb)
     : m_messageBus      (mb),
+    m_resimulating      (false),
     m_entityManager     (mb),
-    m_systemManager     (*this)
+    m_systemManager     (*this, m_entityManager)
 {
     auto defaultCamera = createEntity();
     defaultCamera.addComponent<Transform>().setPosition(xy::DefaultSceneSize / 2.f);
@@ -83,36 +86,49 @@ Scene::Scene(MessageBus& mb)
 //public
 void Scene::update(float dt)
 {
+    //components marked as changed from here on belong to the new version
+    m_entityManager.nextVersion();
+
     //update directors first as they'll be working on data from the last frame
     for (auto& d : m_directors)
     {
         d->process(dt);
     }
 
-    for (const auto& entity : m_pendingEntities)
-    {
-        m_systemManager.addToSystems(entity);
-    }
-    m_pendingEntities.clear();
-
-    for (const auto& entity : m_destroyedEntities)
-    {
-        m_systemManager.removeFromSystems(entity);
-        m_entityManager.destroyEntity(entity);
-    }
-    m_destroyedEntities.clear();
-
+    updateEntities();
 
     m_systemManager.process(dt);
+    updateTransforms();
+
     for (auto& p : m_postEffects) p->update(dt);
 }
 
+void Scene::resimulate(float dt)
+{
+    m_resimulating = true;
+    m_entityManager.nextVersion();
+
+    updateEntities();
+    m_systemManager.resimulate(dt);
+    updateTransforms();
+
+    m_resimulating = false;
+}
+
 Entity Scene::createEntity()
 {
     m_pendingEntities.push_back(m_entityManager.createEntity());
     return m_pendingEntities.back();
 }
 
+std::vector<Entity> Scene::instantiate(const Prefab& prefab, std::size_t count)
+{
+    auto entities = m_entityManager.createEntities(count);
+    prefab.instantiate(m_entityManager, entities);
+    m_pendingEntities.insert(m_pendingEntities.end(), entities.begin(), entities.end());
+    return entities;
+}
+
 void Scene::destroyEntity(Entity entity)
 {
     m_destroyedEntities.push_back(entity);
@@ -123,6 +139,43 @@ Entity Scene::getEntity(Entity::ID id) const
     return m_entityManager.getEntity(id);
 }
 
+void Scene::createSnapshot(Snapshot& snapshot) const
+{
+    m_entityManager.createSnapshot(snapshot);
+}
+
+bool Scene::restoreSnapshot(const Snapshot& snapshot)
+{
+    std::vector<Entity> entities;
+    if (!m_entityManager.getSnapshotChanges(snapshot, entities))
+    {
+        return false;
+    }
+    m_systemManager.removeFromSystems(entities);
+
+    entities.clear();
+    m_entityManager.restoreSnapshot(snapshot, entities);
+    m_systemManager.addToSystems(entities);
+
+    //pending entities were either created since the snapshot and no
+    //longer exist, or may have just been submitted with the restored ones
+    std::vector<bool> submitted(m_entityManager.getEntityCapacity());
+    for (auto entity : entities)
+    {
+        submitted[entity.getIndex()] = true;
+    }
+    m_pendingEntities.erase(std::remove_if(m_pendingEntities.begin(), m_pendingEntities.end(),
+        [&](Entity entity)
+    {
+        return entity.getIndex() >= submitted.size()
+            || submitted[entity.getIndex()]
+            || m_entityManager.entityDestroyed(entity);
+    }), m_pendingEntities.end());
+    m_destroyedEntities.clear();
+
+    return true;
+}
+
 void Scene::setPostEnabled(bool enabled)
 {
     if (enabled && !m_postEffects.empty())
@@ -192,7 +245,7 @@ void Scene::forwardEvent(const sf::Event& evt)
 void Scene::forwardMessage(const Message& msg)
 {
     m_systemManager.forwardMessage(msg);
-    for (auto& d : m_directors)
+    for (auto d : m_directorSubscribers.get(msg.id))
     {
         d->handleMessage(msg);
     }
@@ -223,6 +276,84 @@ void Scene::forwardMessage(const Message& msg)
 }
 
 //private
+void Scene::updateEntities()
+{
+    if (!m_pendingEntities.empty())
+    {
+        m_systemManager.addToSystems(m_pendingEntities);
+        for (const auto& entity : m_pendingEntities)
+        {
+            m_entityManager.setSubmitted(entity);
+        }
+        m_pendingEntities.clear();
+    }
+
+    //entities which have had components added or removed. Systems
+    //are updated before removed components are actually destroyed
+    //so that they are still available to onEntityRemoved()
+    const auto& changedEntities = m_entityManager.getChangedEntities();
+    if (!changedEntities.empty())
+    {
+        for (const auto& entity : changedEntities)
+        {
+            if (!m_entityManager.entityDestroyed(entity))
+            {
+                m_systemManager.updateSystems(entity, m_entityManager.getPendingMask(entity));
+            }
+        }
+        m_entityManager.applyChanges();
+    }
+
+    if (!m_destroyedEntities.empty())
+    {
+        m_systemManager.removeFromSystems(m_destroyedEntities);
+        m_entityManager.destroyEntities(m_destroyedEntities);
+        m_destroyedEntities.clear();
+    }
+}
+
+void Scene::updateTransforms()
+{
+    //setters only mark the transform they modify, as systems may set
+    //transforms from several threads, so the children of each dirty
+    //transform are marked here first, where nothing else is running
+    auto transforms = m_entityManager.view<Transform>();
+    transforms.each([](Entity, Transform& tx)
+    {
+        if (tx.m_dirty)
+        {
+            for (auto child : tx.m_children)
+            {
+                tx.getRelative(child).markDirty();
+            }
+        }
+    });
+
+    //any dirty transform without a dirty parent is then the root of a
+    //modified branch, so each branch is updated in a single pass from its root.
+    m_movedEntities.clear();
+    transforms.each([this](Entity entity, Transform& tx)
+    {
+        if (tx.m_dirty
+            && (tx.m_parent == Transform::NoEntity || !tx.getRelative(tx.m_parent).m_dirty))
+        {
+            //the queue is left holding the rest of the branch
+            tx.updateBranch(m_transformQueue);
+
+            m_movedEntities.push_back(entity);
+            for (auto index : m_transformQueue)
+            {
+                m_movedEntities.push_back(m_entityManager.getEntity(index));
+            }
+        }
+    });
+
+    if (!m_movedEntities.empty())
+    {
+        m_entityManager.markChanged(m_movedEntities, Component::getID<Transform>());
+    }
+}
+
 void Scene::postRenderPath(sf::RenderTarget& rt, sf::RenderStates states)
 {
     m_sceneBuffer.setView(getEntity(m_activeCamera).getComponent<Camera>().m_view);
@@ -0,0 +1,95 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/ecs/Snapshot.hpp>
+#include <xyginext/ecs/Entity.hpp>
+#include <xyginext/core/Log.hpp>
+
+#include <fstream>
+#include <cstring>
+
+using namespace xy;
+
+bool Snapshot::setData(const char* data, std::size_t size)
+{
+    m_data.assign(data, data + size);
+    m_verified.reset();
+    return isValid();
+}
+
+bool Snapshot::isValid() const
+{
+    if (m_data.size() < sizeof(Detail::SnapshotHeader))
+    {
+        return false;
+    }
+
+    Detail::SnapshotHeader header;
+    std::memcpy(&header, m_data.data(), sizeof(header));
+
+    return header.magic == Detail::SnapshotHeader::Magic
+        && header.version == Detail::SnapshotHeader::CurrentVersion
+        && header.handleSize == sizeof(Entity::Handle)
+        && m_data.size() >= sizeof(header) + (header.slotCount * sizeof(Entity::Handle));
+}
+
+bool Snapshot::saveToFile(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open() || !file.good())
+    {
+        Logger::log("Failed opening " + path + " for writing", Logger::Type::Error);
+        return false;
+    }
+
+    file.write(m_data.data(), m_data.size());
+    return file.good();
+}
+
+bool Snapshot::loadFromFile(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open() || !file.good())
+    {
+        Logger::log(path + " file invalid or not found.", Logger::Type::Error);
+        return false;
+    }
+
+    const auto size = static_cast<std::size_t>(file.tellg());
+    file.seekg(0);
+    m_data.resize(size);
+    file.read(m_data.data(), size);
+    m_verified.reset();
+
+    if (!isValid())
+    {
+        Logger::log(path + " is not a valid snapshot", Logger::Type::Error);
+        m_data.clear();
+        return false;
+    }
+    return true;
+}
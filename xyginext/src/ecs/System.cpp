@@ -27,8 +27,16 @@ source distribution.
 
 #include <xyginext/ecs/System.hpp>
 
+#include <limits>
+#include <algorithm>
+
 using namespace xy;
 
+namespace
+{
+    const std::uint32_t InvalidSlot = std::numeric_limits<std::uint32_t>::max();
+}
+
 std::vector<Entity> System::getEntities() const
 {
     return m_entities;
@@ -37,22 +45,86 @@ std::vector<Entity> System::getEntities() const
 //public
 void System::addEntity(Entity entity)
 {
+    const auto index = entity.getIndex();
+    if (index >= m_entitySlots.size())
+    {
+        m_entitySlots.resize(index + 1, InvalidSlot);
+    }
+    XY_ASSERT(m_entitySlots[index] == InvalidSlot, "Entity already added to system");
+
+    m_entitySlots[index] = static_cast<std::uint32_t>(m_entities.size());
     m_entities.push_back(entity);
     onEntityAdded(entity);
 }
 
 void System::removeEntity(Entity entity)
 {
-    m_entities.erase(std::remove_if(std::begin(m_entities), std::end(m_entities),
-        [&entity, this](const Entity& e)
+    if (!hasEntity(entity))
+    {
+        return;
+    }
+
+    const auto index = entity.getIndex();
+    const auto slot = m_entitySlots[index];
+    onEntityRemoved(m_entities[slot]);
+
+    //swap and pop
+    if (slot != m_entities.size() - 1)
+    {
+        m_entities[slot] = m_entities.back();
+        m_entitySlots[m_entities[slot].getIndex()] = slot;
+    }
+    m_entities.pop_back();
+    m_entitySlots[index] = InvalidSlot;
+}
+
+void System::removeEntities(const std::vector<Entity>& entities)
+{
+    bool removed = false;
+    for (auto entity : entities)
     {
-        if (entity == e)
+        if (hasEntity(entity))
         {
-            onEntityRemoved(e);
-            return true;
+            const auto index = entity.getIndex();
+            onEntityRemoved(m_entities[m_entitySlots[index]]);
+            m_entitySlots[index] = InvalidSlot;
+            removed = true;
         }
+    }
+
+    if (removed)
+    {
+        //compact the list keeping only those which still have a slot
+        std::size_t count = 0;
+        for (auto i = 0u; i < m_entities.size(); ++i)
+        {
+            const auto index = m_entities[i].getIndex();
+            if (m_entitySlots[index] != InvalidSlot)
+            {
+                m_entitySlots[index] = static_cast<std::uint32_t>(count);
+                m_entities[count++] = m_entities[i];
+            }
+        }
+        m_entities.resize(count);
+    }
+}
+
+bool System::hasEntity(Entity entity) const
+{
+    const auto index = entity.getIndex();
+    if (index >= m_entitySlots.size()
+        || m_entitySlots[index] == InvalidSlot)
+    {
         return false;
-    }), std::end(m_entities));
+    }
+
+    if (!(m_entities[m_entitySlots[index]] == entity))
+    {
+        //the list was reordered via getEntities()
+        rebuildSlots();
+    }
+    return m_entitySlots[index] != InvalidSlot
+        && m_entities[m_entitySlots[index]] == entity;
 }
 
 const ComponentMask& System::getComponentMask() const
@@ -60,11 +132,43 @@ const ComponentMask& System::getComponentMask() const
     return m_componentMask;
 }
 
+bool System::canRunWith(const System& other) const
+{
+    if (!m_accessDeclared || !other.m_accessDeclared)
+    {
+        return false;
+    }
+
+    if ((m_writeMask & (other.m_readMask | other.m_writeMask)).any()
+        || (other.m_writeMask & m_readMask).any())
+    {
+        return false;
+    }
+
+    return !(m_postsMessages || other.m_postsMessages);
+}
+
 void System::handleMessage(const Message&) {}
 
 void System::process(float) {}
 
 //protected
+void System::subscribe(Message::ID id)
+{
+    XY_ASSERT(!m_scene, "Systems must subscribe to messages in their constructor");
+    XY_ASSERT(id >= 0, "Invalid message ID");
+    if (std::find(m_subscriptions.begin(), m_subscriptions.end(), id) == m_subscriptions.end())
+    {
+        m_subscriptions.push_back(id);
+    }
+}
+
+void System::subscribeAll()
+{
+    XY_ASSERT(!m_scene, "Systems must subscribe to messages in their constructor");
+    m_subscribesAll = true;
+}
+
 void System::setScene(Scene& scene)
 {
     m_scene = &scene;
@@ -74,4 +178,34 @@ Scene* System::getScene()
 {
     XY_ASSERT(m_scene, "Scene is nullptr - something went wrong!");
     return m_scene;
-}
\ No newline at end of file
+}
+
+//private
+void System::rebuildSlots() const
+{
+    for (auto i = 0u; i < m_entities.size(); ++i)
+    {
+        m_entitySlots[m_entities[i].getIndex()] = static_cast<std::uint32_t>(i);
+    }
+}
+
+const std::vector<Entity>& System::getChanged(Component::ID componentID)
+{
+    XY_ASSERT(m_entityManager, "System has not been added to a Scene");
+
+    m_changed.clear();
+    if (!m_entityManager->getChanged(componentID, m_lastVersion, m_changed))
+    {
+        //changes have been missed, so play it safe
+        m_changed = m_entities;
+        return m_changed;
+    }
+
+    m_changed.erase(std::remove_if(m_changed.begin(), m_changed.end(),
+        [this](Entity entity)
+    {
+        return !hasEntity(entity);
+    }), m_changed.end());
+
+    return m_changed;
+}
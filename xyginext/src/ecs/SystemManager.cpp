@@ -29,15 +29,38 @@ source distribution.
 
 using namespace xy;
 
-SystemManager::SystemManager(Scene& scene) : m_scene(scene) {}
+SystemManager::SystemManager(Scene& scene, EntityManager& entityManager)
+    : m_scene       (scene),
+    m_entityManager (entityManager),
+    m_graphDirty    (false),
+    m_frameTime     (0.f)
+{
+
+}
 
 void SystemManager::addToSystems(Entity entity)
 {
-    const auto& entMask = entity.getComponentMask();
-    for (auto& sys : m_systems)
+    for (auto* sys : getMatchingSystems(entity.getComponentMask()))
     {
-        const auto& sysMask = sys->getComponentMask();
-        if ((entMask & sysMask) == sysMask)
+        sys->addEntity(entity);
+    }
+}
+
+void SystemManager::addToSystems(const std::vector<Entity>& entities)
+{
+    const std::vector<System*>* systems = nullptr;
+    ComponentMask lastMask;
+
+    for (auto entity : entities)
+    {
+        const auto& entMask = entity.getComponentMask();
+        if (!systems || entMask != lastMask)
+        {
+            systems = &getMatchingSystems(entMask);
+            lastMask = entMask;
+        }
+
+        for (auto* sys : *systems)
         {
             sys->addEntity(entity);
         }
@@ -52,9 +75,37 @@ void SystemManager::removeFromSystems(Entity entity)
     }
 }
 
-void SystemManager::forwardMessage(const Message& msg)
+void SystemManager::removeFromSystems(const std::vector<Entity>& entities)
 {
     for (auto& sys : m_systems)
+    {
+        sys->removeEntities(entities);
+    }
+}
+
+void SystemManager::updateSystems(Entity entity, const ComponentMask& entMask)
+{
+    for (auto& sys : m_systems)
+    {
+        const auto& sysMask = sys->getComponentMask();
+        const bool matches = ((entMask & sysMask) == sysMask);
+        if (matches != sys->hasEntity(entity))
+        {
+            if (matches)
+            {
+                sys->addEntity(entity);
+            }
+            else
+            {
+                sys->removeEntity(entity);
+            }
+        }
+    }
+}
+
+void SystemManager::forwardMessage(const Message& msg)
+{
+    for (auto sys : m_subscribers.get(msg.id))
     {
         sys->handleMessage(msg);
     }
@@ -62,8 +113,152 @@ void SystemManager::forwardMessage(const Message& msg)
 
 void SystemManager::process(float dt)
 {
-    for (auto& system : m_activeSystems)
+    if (m_graphDirty)
+    {
+        buildGraph();
+    }
+
+    m_frameTime = dt;
+    const bool concurrent = (JobSystem::getActiveWorkerCount() > 0);
+    for (auto& stage : m_stages)
+    {
+        if (concurrent && stage.taskGraph.size() > 1)
+        {
+            stage.taskGraph.execute();
+        }
+        else
+        {
+            for (auto* system : stage.systems)
+            {
+                processSystem(*system, dt);
+            }
+        }
+    }
+}
+
+void SystemManager::resimulate(float dt)
+{
+    //resimulated steps are usually run several times in a single
+    //frame, with few systems, so aren't worth building a graph for
+    for (auto system : m_activeSystems)
+    {
+        if (system->canResimulate())
+        {
+            processSystem(*system, dt);
+        }
+    }
+}
+
+//private
+void SystemManager::buildGraph()
+{
+    m_stages.clear();
+
+    //systems which don't declare their access may touch anything, and messages
+    //posted from a worker thread are staged until the next swap, so both are
+    //processed on the calling thread, in order, as a stage of their own
+    const auto inGraph = [](const System& system)
+    {
+        return system.declaresAccess() && !system.canPostMessages();
+    };
+
+    for (auto* system : m_activeSystems)
+    {
+        if (m_stages.empty() || !inGraph(*system)
+            || !inGraph(*m_stages.back().systems.front()))
+        {
+            m_stages.emplace_back();
+        }
+        m_stages.back().systems.push_back(system);
+    }
+
+    for (auto& stage : m_stages)
+    {
+        const auto& systems = stage.systems;
+        if (systems.size() < 2)
+        {
+            continue;
+        }
+
+        for (auto* system : systems)
+        {
+            stage.taskGraph.addTask([this, system]()
+            {
+                processSystem(*system, m_frameTime);
+            });
+        }
+
+        //systems which conflict are processed in the order in which they were added
+        for (auto i = 0u; i < systems.size(); ++i)
+        {
+            for (auto j = i + 1; j < systems.size(); ++j)
+            {
+                if (!systems[i]->canRunWith(*systems[j]))
+                {
+                    stage.taskGraph.addDependency(i, j);
+                }
+            }
+        }
+    }
+    m_graphDirty = false;
+}
+
+void SystemManager::processSystem(System& system, float dt)
+{
+#ifdef XY_DEBUG
+    auto* previousContext = JobSystem::getContext();
+    JobSystem::setContext(&system);
+    system.m_processing = true;
+#endif
+
+    system.process(dt);
+    system.m_lastVersion = system.m_entityManager->getVersion();
+
+#ifdef XY_DEBUG
+    system.m_processing = false;
+    JobSystem::setContext(previousContext);
+#endif
+}
+
+void SystemManager::updateSubscribers()
+{
+    m_subscribers.clear();
+    for (const auto& sys : m_systems)
+    {
+        m_subscribers.add(sys.get(), sys->m_subscriptions, sys->m_subscribesAll);
+    }
+}
+
+const std::vector<System*>& SystemManager::getMatchingSystems(const ComponentMask& entMask)
+{
+    auto result = m_maskCache.find(entMask);
+    if (result == m_maskCache.end())
+    {
+        std::vector<System*> systems;
+        for (auto& sys : m_systems)
+        {
+            const auto& sysMask = sys->getComponentMask();
+            if ((entMask & sysMask) == sysMask)
+            {
+                systems.push_back(sys.get());
+            }
+        }
+        result = m_maskCache.emplace(entMask, std::move(systems)).first;
+    }
+    return result->second;
+}
+
+void Detail::checkComponentAccess(std::size_t componentID)
+{
+#ifdef XY_DEBUG
+    //the context is only ever set to a system by processSystem()
+    const auto* system = static_cast<const System*>(JobSystem::getContext());
+    if (system && system->declaresAccess())
     {
-        system->process(dt);
+        XY_ASSERT(system->getReadMask()[componentID] || system->getWriteMask()[componentID],
+            "System " << system->getType().name() << " accessed component ID " << componentID << " without declaring it");
     }
+#else
+    (void)componentID;
+#endif //XY_DEBUG
 }
\ No newline at end of file
@@ -38,17 +38,30 @@ Drawable::Drawable(const sf::Texture& texture)
 
 void Drawable::setTexture(const sf::Texture* texture) 
 {
-    m_states.texture = texture;
+    //states are part of the RenderSystem sort key
+    if (m_states.texture != texture)
+    {
+        m_states.texture = texture;
+        m_wantsSorting = true;
+    }
 }
 
 void Drawable::setShader(sf::Shader* shader)
 {
-    m_states.shader = shader;
+    if (m_states.shader != shader)
+    {
+        m_states.shader = shader;
+        m_wantsSorting = true;
+    }
 }
 
 void Drawable::setBlendMode(sf::BlendMode mode)
 {
-    m_states.blendMode = mode;
+    if (m_states.blendMode != mode)
+    {
+        m_states.blendMode = mode;
+        m_wantsSorting = true;
+    }
 }
 
 const sf::Texture* Drawable::getTexture() const
@@ -68,29 +81,33 @@ sf::FloatRect Drawable::getLocalBounds() const
 
 void Drawable::updateLocalBounds()
 {
-    m_localBounds.left = std::numeric_limits<float>::max();
-    m_localBounds.top = std::numeric_limits<float>::max();
-    m_localBounds.width = 0.f;
-    m_localBounds.height = 0.f;
+    sf::FloatRect bounds(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0.f, 0.f);
 
     for (auto& v : m_vertices)
     {
-        if (v.position.x < m_localBounds.left)
+        if (v.position.x < bounds.left)
         {
-            m_localBounds.left = v.position.x;
+            bounds.left = v.position.x;
         }
-        else if (v.position.x - m_localBounds.left > m_localBounds.width)
+        else if (v.position.x - bounds.left > bounds.width)
         {
-            m_localBounds.width = v.position.x - m_localBounds.left;
+            bounds.width = v.position.x - bounds.left;
         }
 
-        if (v.position.y < m_localBounds.top)
+        if (v.position.y < bounds.top)
         {
-            m_localBounds.top = v.position.y;
+            bounds.top = v.position.y;
         }
-        else if (v.position.y - m_localBounds.top > m_localBounds.height)
+        else if (v.position.y - bounds.top > bounds.height)
         {
-            m_localBounds.height = v.position.y - m_localBounds.top;
+            bounds.height = v.position.y - bounds.top;
         }
     }
+
+    //lets the RenderSystem know its cached world bounds are out of date
+    if (bounds != m_localBounds)
+    {
+        m_localBounds = bounds;
+        m_boundsChanged = true;
+    }
 }
\ No newline at end of file
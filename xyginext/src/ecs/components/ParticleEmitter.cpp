@@ -180,4 +180,56 @@ bool EmitterSettings::loadFromFile(const std::string& path, TextureResource& tex
     }
 
     return false;
+}
+
+namespace
+{
+    struct SerialisedEmitter final
+    {
+        EmitterSettings settings;
+        sf::FloatRect bounds;
+        sf::Uint32 particleCount = 0;
+        sf::Int32 releaseCount = 0;
+        bool running = false;
+    };
+}
+
+void ComponentSerialiser<ParticleEmitter>::write(const ParticleEmitter& emitter, std::vector<char>& dst)
+{
+    SerialisedEmitter data;
+    data.settings = emitter.settings;
+    data.settings.texture = nullptr;
+    data.bounds = emitter.m_bounds;
+    data.particleCount = static_cast<sf::Uint32>(emitter.m_nextFreeParticle);
+    data.releaseCount = emitter.m_releaseCount;
+    data.running = emitter.m_running;
+
+    const auto* bytes = reinterpret_cast<const char*>(&data);
+    dst.insert(dst.end(), bytes, bytes + sizeof(data));
+
+    bytes = reinterpret_cast<const char*>(emitter.m_particles.data());
+    dst.insert(dst.end(), bytes, bytes + (emitter.m_nextFreeParticle * sizeof(Particle)));
+}
+
+bool ComponentSerialiser<ParticleEmitter>::read(ParticleEmitter& emitter, SnapshotReader& src)
+{
+    SerialisedEmitter data;
+    if (!src.read(static_cast<void*>(&data), sizeof(data))
+        || data.particleCount > ParticleEmitter::MaxParticles
+        || !src.read(emitter.m_particles.data(), data.particleCount * sizeof(Particle)))
+    {
+        return false;
+    }
+
+    auto* texture = emitter.settings.texture;
+    emitter.settings = data.settings;
+    emitter.settings.texture = texture;
+
+    emitter.m_bounds = data.bounds;
+    emitter.m_nextFreeParticle = data.particleCount;
+    emitter.m_releaseCount = data.releaseCount;
+    emitter.m_running = data.running;
+    emitter.m_emissionClock.restart();
+
+    return true;
 }
\ No newline at end of file
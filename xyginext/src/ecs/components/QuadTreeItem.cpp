@@ -41,4 +41,16 @@ QuadTreeItem::QuadTreeItem()
 void QuadTreeItem::setArea(sf::FloatRect rect)
 {
     m_area = rect; //TODO flag update
+}
+
+void ComponentSerialiser<QuadTreeItem>::write(const QuadTreeItem& item, std::vector<char>& dst)
+{
+    const auto* bytes = reinterpret_cast<const char*>(&item.m_area);
+    dst.insert(dst.end(), bytes, bytes + sizeof(item.m_area));
+}
+
+bool ComponentSerialiser<QuadTreeItem>::read(QuadTreeItem& item, SnapshotReader& src)
+{
+    //the tree and node are left as they are, as they belong to the QuadTree system
+    return src.read(item.m_area);
 }
\ No newline at end of file
@@ -78,4 +78,47 @@ sf::Color Sprite::getColour() const
 {
     return m_colour;
     
-}
\ No newline at end of file
+}
+
+namespace
+{
+    struct SerialisedSprite final
+    {
+        sf::FloatRect textureRect;
+        sf::Color colour;
+        sf::Uint32 animationCount = 0;
+    };
+}
+
+void ComponentSerialiser<Sprite>::write(const Sprite& sprite, std::vector<char>& dst)
+{
+    SerialisedSprite data;
+    data.textureRect = sprite.m_textureRect;
+    data.colour = sprite.m_colour;
+    data.animationCount = static_cast<sf::Uint32>(sprite.m_animationCount);
+
+    const auto* bytes = reinterpret_cast<const char*>(&data);
+    dst.insert(dst.end(), bytes, bytes + sizeof(data));
+
+    //only the animations in use are written, rather than the whole table
+    bytes = reinterpret_cast<const char*>(sprite.m_animations.data());
+    dst.insert(dst.end(), bytes, bytes + (sprite.m_animationCount * sizeof(Sprite::Animation)));
+}
+
+bool ComponentSerialiser<Sprite>::read(Sprite& sprite, SnapshotReader& src)
+{
+    SerialisedSprite data;
+    if (!src.read(data)
+        || data.animationCount > Sprite::MaxAnimations
+        || !src.read(sprite.m_animations.data(), data.animationCount * sizeof(Sprite::Animation)))
+    {
+        return false;
+    }
+
+    sprite.m_textureRect = data.textureRect;
+    sprite.m_colour = data.colour;
+    sprite.m_animationCount = data.animationCount;
+    sprite.m_dirty = true;
+
+    return true;
+}
@@ -0,0 +1,140 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/ecs/components/TileMap.hpp>
+#include <xyginext/core/Assert.hpp>
+#include <xyginext/core/Log.hpp>
+
+#include <algorithm>
+
+using namespace xy;
+
+constexpr std::size_t TileMap::InvalidLayer;
+
+TileMap::TileMap()
+    : m_tileSize    (16.f, 16.f),
+    m_chunkSize     (32, 32),
+    m_dirty         (true)
+{
+
+}
+
+//public
+void TileMap::setTileSize(sf::Vector2f size)
+{
+    XY_ASSERT(size.x > 0 && size.y > 0, "Tile size must be greater than zero");
+    m_tileSize = size;
+    m_dirty = true;
+}
+
+void TileMap::setChunkSize(sf::Vector2u size)
+{
+    XY_ASSERT(size.x > 0 && size.y > 0, "Chunk size must be greater than zero");
+    m_chunkSize = size;
+    m_dirty = true;
+}
+
+void TileMap::addTileset(const Tileset& tileset)
+{
+    XY_ASSERT(tileset.texture, "Tileset has no texture");
+    XY_ASSERT(tileset.columns > 0 && tileset.tileCount > 0, "Tileset has no tiles");
+    m_tilesets.push_back(tileset);
+    m_dirty = true;
+}
+
+std::size_t TileMap::addLayer(const std::vector<sf::Uint32>& tiles, sf::Vector2u size)
+{
+    if (tiles.size() != static_cast<std::size_t>(size.x) * size.y)
+    {
+        Logger::log("Tile count " + std::to_string(tiles.size()) + " does not match layer size "
+            + std::to_string(size.x) + "x" + std::to_string(size.y) + ", layer not added", Logger::Type::Error);
+        return InvalidLayer;
+    }
+
+    Layer layer;
+    layer.tiles = tiles;
+    layer.size = size;
+    m_layers.push_back(std::move(layer));
+    m_dirty = true;
+
+    return m_layers.size() - 1;
+}
+
+void TileMap::addAnimation(sf::Uint32 tileID, const std::vector<AnimationFrame>& frames)
+{
+    if (frames.empty())
+    {
+        Logger::log("Animation for tile " + std::to_string(tileID) + " has no frames, not added", Logger::Type::Error);
+        return;
+    }
+
+    Animation animation;
+    for (const auto& frame : frames)
+    {
+        //also rejects NaN
+        if (!(frame.duration > 0.f))
+        {
+            Logger::log("Animation for tile " + std::to_string(tileID) + " has a frame without a positive duration, not added", Logger::Type::Error);
+            return;
+        }
+        animation.duration += frame.duration;
+    }
+    animation.frames = frames;
+
+    auto result = m_animationIndices.find(tileID);
+    if (result != m_animationIndices.end())
+    {
+        m_animations[result->second] = std::move(animation);
+    }
+    else
+    {
+        m_animationIndices.insert(std::make_pair(tileID, m_animations.size()));
+        m_animations.push_back(std::move(animation));
+    }
+    m_dirty = true;
+}
+
+void TileMap::clear()
+{
+    m_tilesets.clear();
+    m_layers.clear();
+    m_animations.clear();
+    m_animationIndices.clear();
+    m_chunks.clear();
+    m_dirty = true;
+}
+
+sf::FloatRect TileMap::getLocalBounds() const
+{
+    sf::Vector2u size;
+    for (const auto& layer : m_layers)
+    {
+        size.x = std::max(size.x, layer.size.x);
+        size.y = std::max(size.y, layer.size.y);
+    }
+    return { 0.f, 0.f, size.x * m_tileSize.x, size.y * m_tileSize.y };
+}
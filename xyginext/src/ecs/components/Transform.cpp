@@ -26,163 +26,455 @@ source distribution.
 *********************************************************************/
 
 #include <xyginext/ecs/components/Transform.hpp>
+#include <xyginext/ecs/ComponentPool.hpp>
 #include <xyginext/core/Assert.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 using namespace xy;
 
+constexpr sf::Uint32 Transform::NoEntity;
+
 Transform::Transform()
-    : m_parent(nullptr)
+    : m_pool    (nullptr),
+    m_entity    (NoEntity),
+    m_parent    (NoEntity),
+    m_dirty     (true)
 {
 
 }
 
-Transform::~Transform()
+Transform::Transform(Transform&& other)
+    : sf::Transformable(other),
+    m_pool          (other.m_pool),
+    m_entity        (other.m_entity),
+    m_parent        (other.m_parent),
+    m_children      (std::move(other.m_children)),
+    m_worldTransform(other.m_worldTransform),
+    m_dirty         (other.m_dirty)
 {
-    //remove this transform from its parent
-    if (m_parent)
+    //relationships are stored by entity index so moving
+    //the transform doesn't affect its parent or children.
+    //Transforms are moved whenever their entity changes table
+    //so the base is copied whole above rather than via its setters.
+    other.m_pool = nullptr;
+    other.m_entity = NoEntity;
+    other.m_parent = NoEntity;
+    other.m_children.clear();
+    other.m_dirty = true;
+}
+
+Transform& Transform::operator=(Transform&& other)
+{
+    if (&other != this)
     {
-        auto& siblings = m_parent->m_children;
-        siblings.erase(
-            std::remove_if(siblings.begin(), siblings.end(),
-                [this](const Transform* ptr)
-        {return ptr == this; }),
-            siblings.end());
+        //a transform replaced in its pool without being removed first
+        //mustn't leave its parent or children referring to it
+        unlink();
+
+        m_pool = other.m_pool;
+        m_entity = other.m_entity;
+        m_parent = other.m_parent;
+        m_children = std::move(other.m_children);
+        m_worldTransform = other.m_worldTransform;
+        m_dirty = other.m_dirty;
+
+        sf::Transformable::operator=(other);
+
+        other.m_pool = nullptr;
+        other.m_entity = NoEntity;
+        other.m_parent = NoEntity;
+        other.m_children.clear();
+        other.m_dirty = true;
     }
+    return *this;
+}
 
-    //orphan any children
-    for(auto c : m_children)
+//public
+void Transform::addChild(Transform& child)
+{
+    XY_ASSERT(this != &child, "Can't parent to ourself!");
+    XY_ASSERT(m_pool && m_pool == child.m_pool, "Transforms must be added to entities in the same Scene before parenting");
+
+    //remove old parent first
+    if (child.m_parent != NoEntity)
     {
-        c->m_parent = nullptr;
+        if (child.m_parent == m_entity)
+        {
+            return; //already added!
+        }
+
+        auto& otherSiblings = getRelative(child.m_parent).m_children;
+        otherSiblings.erase(std::remove(otherSiblings.begin(), otherSiblings.end(), child.m_entity), otherSiblings.end());
     }
+    child.m_parent = m_entity;
+    m_children.push_back(child.m_entity);
+    child.markDirty();
 }
 
-Transform::Transform(Transform&& other)
+void Transform::removeChild(Transform& tx)
 {
-    m_parent = other.m_parent;
-    other.m_parent = nullptr;
+    if (m_entity == NoEntity || tx.m_parent != m_entity) return;
 
-    //swap ourself into siblings list
-    if (m_parent)
+    tx.m_parent = NoEntity;
+    m_children.erase(std::remove(m_children.begin(), m_children.end(), tx.m_entity), m_children.end());
+    tx.markDirty();
+}
+
+sf::Transform Transform::getWorldTransform() const
+{
+    //setters only mark the transform they modify, so the cached world
+    //transform is out of date if this or any of its parents are dirty.
+    //Those above the topmost dirty transform are still up to date.
+    const Transform* top = nullptr;
+    for (auto tx = this; tx != nullptr; tx = (tx->m_parent == NoEntity) ? nullptr : &getRelative(tx->m_parent))
     {
-        auto& siblings = m_parent->m_children;
-        for (auto& s : siblings)
+        if (tx->m_dirty)
         {
-            if (s == &other)
-            {
-                s = this;
-                break;
-            }
+            top = tx;
         }
     }
-    m_children = std::move(other.m_children);
 
-    //update the children's new parent
-    for (auto c : m_children)
+    if (!top)
     {
-        c->m_parent = this;
+        return m_worldTransform;
     }
 
-    //actually take on the other transform
-    setPosition(other.getPosition());
-    setRotation(other.getRotation());
-    setScale(other.getScale());
-    setOrigin(other.getOrigin());
+    //not cached here as transforms may be read from more than one thread
+    auto transform = getLocalTransform();
+    for (auto tx = this; tx != top;)
+    {
+        tx = &getRelative(tx->m_parent);
+        transform = tx->getLocalTransform() * transform;
+    }
 
-    other.setPosition({});
-    other.setRotation(0.f);
-    other.setScale({ 1.f, 1.f });
-    other.setOrigin({});
+    if (top->m_parent != NoEntity)
+    {
+        transform = getRelative(top->m_parent).m_worldTransform * transform;
+    }
+    return transform;
 }
 
-Transform& Transform::operator=(Transform&& other)
+sf::Vector2f Transform::getWorldPosition() const
 {
-    if (&other != this)
-    {
-        m_parent = other.m_parent;
-        other.m_parent = nullptr;
+    return getWorldTransform().transformPoint({});
+}
 
-        //swap ourself into siblings list
-        if (m_parent)
-        {
-            auto& siblings = m_parent->m_children;
-            for (auto& s : siblings)
-            {
-                if (s == &other)
-                {
-                    s = this;
-                    break;
-                }
-            }
-        }
+void Transform::setPosition(float x, float y)
+{
+    sf::Transformable::setPosition(x, y);
+    m_dirty = true;
+}
 
-        m_children = std::move(other.m_children);
+void Transform::setPosition(const sf::Vector2f& position)
+{
+    sf::Transformable::setPosition(position);
+    m_dirty = true;
+}
 
-        //update the children's new parent
-        for (auto c : m_children)
-        {
-            c->m_parent = this;
-        }
+void Transform::setRotation(float angle)
+{
+    sf::Transformable::setRotation(angle);
+    m_dirty = true;
+}
+
+void Transform::setScale(float x, float y)
+{
+    sf::Transformable::setScale(x, y);
+    m_dirty = true;
+}
+
+void Transform::setScale(const sf::Vector2f& factors)
+{
+    sf::Transformable::setScale(factors);
+    m_dirty = true;
+}
+
+void Transform::setOrigin(float x, float y)
+{
+    sf::Transformable::setOrigin(x, y);
+    m_dirty = true;
+}
+
+void Transform::setOrigin(const sf::Vector2f& origin)
+{
+    sf::Transformable::setOrigin(origin);
+    m_dirty = true;
+}
+
+void Transform::move(float x, float y)
+{
+    sf::Transformable::move(x, y);
+    m_dirty = true;
+}
+
+void Transform::move(const sf::Vector2f& offset)
+{
+    sf::Transformable::move(offset);
+    m_dirty = true;
+}
+
+void Transform::rotate(float angle)
+{
+    sf::Transformable::rotate(angle);
+    m_dirty = true;
+}
+
+void Transform::scale(float x, float y)
+{
+    sf::Transformable::scale(x, y);
+    m_dirty = true;
+}
+
+void Transform::scale(const sf::Vector2f& factor)
+{
+    sf::Transformable::scale(factor);
+    m_dirty = true;
+}
 
-        //actually take on the other transform
-        setPosition(other.getPosition());
-        setRotation(other.getRotation());
-        setScale(other.getScale());
-        setOrigin(other.getOrigin());
+//private
+Transform& Transform::getRelative(sf::Uint32 entity) const
+{
+    XY_ASSERT(m_pool, "Transform does not belong to an entity");
+    return static_cast<Detail::PoolType<Transform>*>(m_pool)->at(entity);
+}
+
+sf::Transform Transform::getLocalTransform() const
+{
+    //the same as sf::Transformable::getTransform(), which caches
+    //its result in mutable members, and so can't be called while
+    //other threads may be reading this transform
+    const auto angle = -getRotation() * 3.141592654f / 180.f;
+    const auto cosine = static_cast<float>(std::cos(angle));
+    const auto sine = static_cast<float>(std::sin(angle));
+
+    const auto& scale = getScale();
+    const auto& origin = getOrigin();
+    const auto& position = getPosition();
+
+    const auto sxc = scale.x * cosine;
+    const auto syc = scale.y * cosine;
+    const auto sxs = scale.x * sine;
+    const auto sys = scale.y * sine;
+    const auto tx = -origin.x * sxc - origin.y * sys + position.x;
+    const auto ty = origin.x * sxs - origin.y * syc + position.y;
 
-        other.setPosition({});
-        other.setRotation(0.f);
-        other.setScale({ 1.f, 1.f });
-        other.setOrigin({});
+    return sf::Transform(sxc, sys, tx,
+                        -sxs, syc, ty,
+                        0.f, 0.f, 1.f);
+}
+
+void Transform::markDirty()
+{
+    //any dirty children have either been visited already,
+    //or will be when the Scene marks the children of each
+    //dirty transform, so there's no need to visit them again
+    if (m_dirty)
+    {
+        return;
+    }
+
+    m_dirty = true;
+    for (auto c : m_children)
+    {
+        getRelative(c).markDirty();
     }
-    return *this;
 }
 
-//public
-void Transform::addChild(Transform& child)
+void Transform::unlink()
 {
-    XY_ASSERT(this != &child, "Can't parent to ourself!");
+    if (!m_pool)
+    {
+        return;
+    }
 
-    //remove old parent first
-    if (child.m_parent)
+    if (m_parent != NoEntity)
     {
-        if (child.m_parent == this)
-        {
-            return; //already added!
-        }
+        auto& siblings = getRelative(m_parent).m_children;
+        siblings.erase(std::remove(siblings.begin(), siblings.end(), m_entity), siblings.end());
+        m_parent = NoEntity;
+    }
 
-        auto& otherSiblings = child.m_parent->m_children;
-        otherSiblings.erase(std::remove_if(otherSiblings.begin(), otherSiblings.end(),
-            [&child](const Transform* ptr) 
-        {
-            return ptr == &child;
-        }), otherSiblings.end());
+    //orphan any children
+    for (auto c : m_children)
+    {
+        auto& child = getRelative(c);
+        child.m_parent = NoEntity;
+        child.markDirty();
     }
-    child.m_parent = this;
-    m_children.push_back(&child);
+    m_children.clear();
+    m_dirty = true;
 }
 
-void Transform::removeChild(Transform& tx)
+void Transform::updateBranch(std::vector<sf::Uint32>& queue)
 {
-    if (tx.m_parent != this) return;
+    //breadth first, so that each parent's world transform
+    //is updated before those of its children
+    m_worldTransform = (m_parent == NoEntity) ? getTransform() : getRelative(m_parent).m_worldTransform * getTransform();
+    m_dirty = false;
 
-    tx.m_parent = nullptr;
-    m_children.erase(std::remove_if(m_children.begin(), m_children.end(), 
-        [&tx](const Transform* ptr)
+    queue.assign(m_children.begin(), m_children.end());
+    for (auto i = 0u; i < queue.size(); ++i)
     {
-        return ptr == &tx;
-    }), m_children.end());
+        auto& tx = getRelative(queue[i]);
+        tx.m_worldTransform = getRelative(tx.m_parent).m_worldTransform * tx.getTransform();
+        tx.m_dirty = false;
+        queue.insert(queue.end(), tx.m_children.begin(), tx.m_children.end());
+    }
 }
 
-sf::Transform Transform::getWorldTransform() const
+void ComponentAttachment<Transform>::attach(Transform& tx, std::size_t entity, Detail::Pool& pool)
+{
+    tx.m_pool = &pool;
+    tx.m_entity = static_cast<sf::Uint32>(entity);
+}
+
+void ComponentAttachment<Transform>::detach(Transform& tx)
+{
+    tx.unlink();
+    tx.m_pool = nullptr;
+    tx.m_entity = Transform::NoEntity;
+}
+
+Transform ComponentCopy<Transform>::copy(const Transform& other)
+{
+    Transform tx;
+    tx.setPosition(other.getPosition());
+    tx.setRotation(other.getRotation());
+    tx.setScale(other.getScale());
+    tx.setOrigin(other.getOrigin());
+    return tx;
+}
+
+namespace
+{
+    struct SerialisedTransform final
+    {
+        sf::Vector2f position;
+        float rotation = 0.f;
+        sf::Vector2f scale;
+        sf::Vector2f origin;
+        sf::Uint32 parent = 0;
+        sf::Uint32 childCount = 0;
+    };
+}
+
+void ComponentSerialiser<Transform>::write(const Transform& tx, std::vector<char>& dst)
 {
-    if (m_parent)
+    SerialisedTransform data;
+    data.position = tx.getPosition();
+    data.rotation = tx.getRotation();
+    data.scale = tx.getScale();
+    data.origin = tx.getOrigin();
+    data.parent = tx.m_parent;
+    data.childCount = static_cast<sf::Uint32>(tx.m_children.size());
+
+    const auto* bytes = reinterpret_cast<const char*>(&data);
+    dst.insert(dst.end(), bytes, bytes + sizeof(data));
+
+    bytes = reinterpret_cast<const char*>(tx.m_children.data());
+    dst.insert(dst.end(), bytes, bytes + (tx.m_children.size() * sizeof(sf::Uint32)));
+}
+
+bool ComponentSerialiser<Transform>::read(Transform& tx, SnapshotReader& src)
+{
+    SerialisedTransform data;
+    if (!src.read(data)
+        || (data.parent != Transform::NoEntity && data.parent >= src.getEntityCount())
+        || data.childCount > src.getRemaining() / sizeof(sf::Uint32))
     {
-        return m_parent->getWorldTransform() * getTransform();
+        return false;
     }
-    return getTransform();
+
+    std::vector<sf::Uint32> children(data.childCount);
+    src.read(children.data(), data.childCount * sizeof(sf::Uint32));
+    if (std::any_of(children.begin(), children.end(),
+        [&src](sf::Uint32 child) { return child >= src.getEntityCount(); }))
+    {
+        return false;
+    }
+
+    //every Transform in the Scene is read from the snapshot, and any which
+    //aren't in it have already been removed, so the relationships are replaced
+    //wholesale rather than unlinked first. Every Transform ends up dirty so the
+    //setters aren't used, as they would visit children which may not exist yet.
+    tx.m_parent = data.parent;
+    tx.m_children.swap(children);
+
+    tx.sf::Transformable::setPosition(data.position);
+    tx.sf::Transformable::setRotation(data.rotation);
+    tx.sf::Transformable::setScale(data.scale);
+    tx.sf::Transformable::setOrigin(data.origin);
+    tx.m_dirty = true;
+
+    return true;
 }
 
-sf::Vector2f Transform::getWorldPosition() const
+bool ComponentSerialiser<Transform>::validate(const std::vector<Transform>& transforms, const std::vector<sf::Uint32>& entities)
 {
-    return getWorldTransform().transformPoint({});
-}
\ No newline at end of file
+    //maps entity indices to transforms. Indices have already been
+    //checked against the snapshot's entity count.
+    const sf::Uint32 entityCount = entities.empty() ? 0 : *std::max_element(entities.begin(), entities.end()) + 1;
+    std::vector<const Transform*> lookup(entityCount, nullptr);
+    for (auto i = 0u; i < transforms.size(); ++i)
+    {
+        lookup[entities[i]] = &transforms[i];
+    }
+
+    auto find = [&lookup](sf::Uint32 entity) -> const Transform*
+    {
+        return entity < lookup.size() ? lookup[entity] : nullptr;
+    };
+
+    //every parent must list the transform as a child, and every child must
+    //name the transform as its parent, so each child is listed only once
+    std::size_t childCount = 0;
+    std::size_t parentCount = 0;
+    for (auto i = 0u; i < transforms.size(); ++i)
+    {
+        const auto& tx = transforms[i];
+        if (tx.m_parent != Transform::NoEntity)
+        {
+            const auto* parent = find(tx.m_parent);
+            if (!parent || std::find(parent->m_children.begin(), parent->m_children.end(), entities[i]) == parent->m_children.end())
+            {
+                return false;
+            }
+            parentCount++;
+        }
+
+        for (auto c : tx.m_children)
+        {
+            const auto* child = find(c);
+            if (!child || child->m_parent != entities[i])
+            {
+                return false;
+            }
+        }
+        childCount += tx.m_children.size();
+    }
+
+    if (childCount != parentCount)
+    {
+        return false;
+    }
+
+    //a consistent hierarchy may still contain cycles, which can't be reached
+    //from any root, so every transform must be visited walking down from them
+    std::vector<sf::Uint32> queue;
+    for (auto i = 0u; i < transforms.size(); ++i)
+    {
+        if (transforms[i].m_parent == Transform::NoEntity)
+        {
+            queue.push_back(entities[i]);
+        }
+    }
+
+    for (auto i = 0u; i < queue.size(); ++i)
+    {
+        const auto& children = lookup[queue[i]]->m_children;
+        queue.insert(queue.end(), children.begin(), children.end());
+    }
+    return queue.size() == transforms.size();
+}
@@ -56,16 +56,12 @@ void AudioSystem::process(float)
     sf::Listener::setPosition({ listenerPos.x, listenerPos.y, 100.f });
     sf::Listener::setGlobalVolume(listener.getComponent<AudioListener>().m_volume * AudioMixer::getMasterVolume() * 100.f);
 
-    auto& entities = getEntities();
-    for (auto& entity : entities)
+    view<AudioEmitter, Transform>().eachUnordered([](Entity, AudioEmitter& audio, const Transform& tx)
     {
         //update position of entities
-        const auto& tx = entity.getComponent<xy::Transform>();
-        auto& audio = entity.getComponent<xy::AudioEmitter>();
-
         audio.setPosition(tx.getWorldTransform().transformPoint({}));
 
         //update volume according to global mixer
         audio.m_impl->setVolume(audio.m_volume * AudioMixer::m_channels[audio.m_mixerChannel]);
-    }
+    });
 }
\ No newline at end of file
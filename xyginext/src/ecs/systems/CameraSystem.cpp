@@ -39,17 +39,15 @@ CameraSystem::CameraSystem(MessageBus& mb)
 {
     requireComponent<Transform>();
     requireComponent<Camera>();
+
+    writesComponent<Camera>();
 }
 
 //public
 void CameraSystem::process(float)
 {
-    auto& entities = getEntities();
-    for (auto& entity : entities)
+    view<Transform, Camera>().eachUnordered([](Entity, const Transform& xForm, Camera& cam)
     {
-        auto& cam = entity.getComponent<Camera>();
-        const auto& xForm = entity.getComponent<Transform>();
-       
         auto position = xForm.getWorldTransform().transformPoint({});
 
         //check axis lock
@@ -74,5 +72,5 @@ void CameraSystem::process(float)
         {
             cam.m_view.setRotation(xForm.getRotation());
         }
-    }
+    });
 }
\ No newline at end of file
@@ -30,6 +30,8 @@ source distribution.
 #include <xyginext/ecs/components/NetInterpolation.hpp>
 #include <xyginext/ecs/components/Transform.hpp>
 
+#include <xyginext/core/JobSystem.hpp>
+
 #include <xyginext/util/Vector.hpp>
 
 using namespace xy;
@@ -44,36 +46,43 @@ InterpolationSystem::InterpolationSystem(xy::MessageBus& mb)
 {
     requireComponent<Transform>();
     requireComponent<NetInterpolate>();
+
+    writesComponent<Transform>();
+    writesComponent<NetInterpolate>();
 }
 
 //public
 void InterpolationSystem::process(float dt)
 {
-    auto& entities = getEntities();
-    for (auto& entity : entities)
+    auto entities = view<Transform, NetInterpolate>();
+    JobSystem::parallelFor(entities.size(), [&entities, dt](std::size_t start, std::size_t end)
     {
-        auto& tx = entity.getComponent<Transform>();
-        auto& interp = entity.getComponent<NetInterpolate>();
-
-        //if time has been reset we ought to have reached the previous target by now.
-        if (interp.m_elapsedTime == 0)
+        for (auto i = start; i < end; ++i)
         {
-            tx.setPosition(interp.m_previousPosition);
+            auto components = entities[i];
+            auto& tx = std::get<0>(components);
+            auto& interp = std::get<1>(components);
+
+            //if time has been reset we ought to have reached the previous target by now.
+            if (interp.m_elapsedTime == 0)
+            {
+                tx.setPosition(interp.m_previousPosition);
+            }
+
+            interp.m_elapsedTime += dt;
+
+            auto diff = (interp.m_targetPosition - interp.m_previousPosition);
+            if (Util::Vector::lengthSquared(diff) > MaxDistSqr)
+            {
+                interp.m_elapsedTime = 0;
+                tx.setPosition(interp.m_targetPosition);
+                continue;
+            }
+
+            //previous position + diff * timePassed
+            tx.setPosition(interp.m_previousPosition + (diff * std::min(interp.m_elapsedTime / interp.m_timeDifference, 1.f)));
         }
-
-        interp.m_elapsedTime += dt;
-        
-        auto diff = (interp.m_targetPosition - interp.m_previousPosition);
-        if (Util::Vector::lengthSquared(diff) > MaxDistSqr)
-        {
-            interp.m_elapsedTime = 0;
-            tx.setPosition(interp.m_targetPosition);
-            return;
-        }
-
-        //previous position + diff * timePassed
-        tx.setPosition(interp.m_previousPosition + (diff * std::min(interp.m_elapsedTime / interp.m_timeDifference, 1.f)));
-    }
+    });
 }
 
 //private
@@ -29,6 +29,7 @@ source distribution.
 #include <xyginext/ecs/components/Transform.hpp>
 #include <xyginext/ecs/components/ParticleEmitter.hpp>
 #include <xyginext/core/App.hpp>
+#include <xyginext/core/JobSystem.hpp>
 #include <xyginext/util/Const.hpp>
 #include <xyginext/util/Random.hpp>
 #include <xyginext/util/Vector.hpp>
@@ -116,8 +117,8 @@ ParticleSystem::~ParticleSystem()
 //public
 void ParticleSystem::process(float dt)
 {
-    m_activeArrayCount = 0;
-
+    //emission uses the shared random number generator
+    //so must be done serially to remain deterministic
     auto& entities = getEntities();
     for (auto& entity : entities)
     {
@@ -166,64 +167,77 @@ void ParticleSystem::process(float dt)
             }
         }
         if (emitter.m_releaseCount == 0) emitter.stop();
+    }
 
-        //update each particle
-        sf::Vector2f minBounds(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
-        sf::Vector2f maxBounds;
-        for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
+    //each emitter's particles are independent of the others, as is its
+    //vertex array, so emitters are updated in parallel. The array index
+    //matches the entity index so the draw order is the same as before
+    JobSystem::parallelFor(entities.size(), [this, &entities, dt](std::size_t start, std::size_t end)
+    {
+        for (auto e = start; e < end; ++e)
         {
-            auto& p = emitter.m_particles[i];
+            auto& emitter = entities[e].getComponent<ParticleEmitter>();
 
-            p.velocity += p.gravity * dt;
-            for (auto f : emitter.settings.forces) p.velocity += f * dt;
-            p.position += p.velocity * dt;
-
-            p.lifetime -= dt;
-            p.colour.a = static_cast<sf::Uint8>(255.f * (std::max(p.lifetime / p.maxLifetime, 0.f)));
+            //update each particle
+            sf::Vector2f minBounds(std::numeric_limits<float>::max(), std::numeric_limits<float>::max());
+            sf::Vector2f maxBounds;
+            for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
+            {
+                auto& p = emitter.m_particles[i];
 
-            p.rotation += emitter.settings.rotationSpeed * dt;
-            p.scale += ((p.scale * emitter.settings.scaleModifier) * dt);
+                p.velocity += p.gravity * dt;
+                for (auto f : emitter.settings.forces) p.velocity += f * dt;
+                p.position += p.velocity * dt;
 
-            //update bounds for culling
-            if (p.position.x < minBounds.x) minBounds.x = p.position.x;
-            if (p.position.y < minBounds.y) minBounds.y = p.position.y;
+                p.lifetime -= dt;
+                p.colour.a = static_cast<sf::Uint8>(255.f * (std::max(p.lifetime / p.maxLifetime, 0.f)));
 
-            if (p.position.x > maxBounds.x) maxBounds.x = p.position.x;
-            if (p.position.y > maxBounds.y) maxBounds.y = p.position.y;
-        }
-        emitter.m_bounds = { minBounds, maxBounds - minBounds };
+                p.rotation += emitter.settings.rotationSpeed * dt;
+                p.scale += ((p.scale * emitter.settings.scaleModifier) * dt);
 
+                //update bounds for culling
+                if (p.position.x < minBounds.x) minBounds.x = p.position.x;
+                if (p.position.y < minBounds.y) minBounds.y = p.position.y;
 
-        //go over again and remove dead particles with pop/swap
-        for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
-        {
-            if (emitter.m_particles[i].lifetime < 0)
-            {
-                emitter.m_nextFreeParticle--;
-                std::swap(emitter.m_particles[i], emitter.m_particles[emitter.m_nextFreeParticle]);
+                if (p.position.x > maxBounds.x) maxBounds.x = p.position.x;
+                if (p.position.y > maxBounds.y) maxBounds.y = p.position.y;
             }
-        }
+            emitter.m_bounds = { minBounds, maxBounds - minBounds };
 
-        //limit max number of active systems and generate actual vert array
-        if (m_activeArrayCount < MaxParticleSystems) 
-        {
-            auto& vertArray = m_emitterArrays[m_activeArrayCount++];
-            vertArray.count = 0;
-            vertArray.texture = (emitter.settings.texture) ? emitter.settings.texture : &m_dummyTexture;
-            vertArray.bounds = emitter.m_bounds;
-            vertArray.blendMode = emitter.settings.blendmode;
 
+            //go over again and remove dead particles with pop/swap
             for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
             {
-                vertArray.vertices[vertArray.count++] = 
+                if (emitter.m_particles[i].lifetime < 0)
+                {
+                    emitter.m_nextFreeParticle--;
+                    std::swap(emitter.m_particles[i], emitter.m_particles[emitter.m_nextFreeParticle]);
+                }
+            }
+
+            //limit max number of active systems and generate actual vert array
+            if (e < MaxParticleSystems)
+            {
+                auto& vertArray = m_emitterArrays[e];
+                vertArray.count = 0;
+                vertArray.texture = (emitter.settings.texture) ? emitter.settings.texture : &m_dummyTexture;
+                vertArray.bounds = emitter.m_bounds;
+                vertArray.blendMode = emitter.settings.blendmode;
+
+                for (auto i = 0u; i < emitter.m_nextFreeParticle; ++i)
                 {
-                    emitter.m_particles[i].position,
-                    emitter.m_particles[i].colour,
-                    sf::Vector2f(emitter.m_particles[i].rotation, emitter.m_particles[i].scale)
-                };
+                    vertArray.vertices[vertArray.count++] =
+                    {
+                        emitter.m_particles[i].position,
+                        emitter.m_particles[i].colour,
+                        sf::Vector2f(emitter.m_particles[i].rotation, emitter.m_particles[i].scale)
+                    };
+                }
             }
         }
-    }
+    }, 4);
+
+    m_activeArrayCount = std::min(entities.size(), MaxParticleSystems);
 }
 
 //private
@@ -33,6 +33,7 @@ source distribution.
 #include <xyginext/util/Rectangle.hpp>
 
 #include <xyginext/core/App.hpp>
+#include <xyginext/core/JobSystem.hpp>
 
 #ifdef DDRAW
 #include <SFML/Graphics/RenderTarget.hpp>
@@ -54,9 +55,23 @@ QuadTree::QuadTree(xy::MessageBus& mb, sf::FloatRect rootArea)
 void QuadTree::process(float)
 {
     auto& entities = getEntities();
+
+    //world bounds are written only to each entity's own item, and
+    //transforms, including any parents, are only read, so they can
+    //be calculated in parallel. Updating the tree modifies shared
+    //nodes so has to be done afterwards on a single thread.
+    JobSystem::parallelFor(entities.size(), [&entities](std::size_t start, std::size_t end)
+    {
+        for (auto i = start; i < end; ++i)
+        {
+            auto& item = entities[i].getComponent<xy::QuadTreeItem>();
+            item.m_worldBounds = entities[i].getComponent<xy::Transform>().getWorldTransform().transformRect(item.m_area);
+        }
+    });
+
     for (auto& entity : entities)
     {
-        auto item = entity.getComponent<xy::QuadTreeItem>();
+        const auto& item = entity.getComponent<xy::QuadTreeItem>();
         if (item.m_node)
         {
             item.m_node->update(entity);
@@ -64,8 +79,7 @@ void QuadTree::process(float)
         else
         {
             //we must have been outside, lets see if we entered rhe root
-            auto rect = entity.getComponent<xy::Transform>().getWorldTransform().transformRect(item.m_area);
-            if (Util::Rectangle::contains(m_rootNode.getArea(), rect))
+            if (Util::Rectangle::contains(m_rootNode.getArea(), item.m_worldBounds))
             {
                 m_rootNode.addEntity(entity);
 
@@ -219,8 +233,8 @@ void QuadTree::onEntityAdded(xy::Entity entity)
     auto& item = entity.getComponent<xy::QuadTreeItem>();
     item.m_quadTree = this;
 
-    auto rect = entity.getComponent<xy::Transform>().getWorldTransform().transformRect(item.m_area);
-    if (Util::Rectangle::contains(m_rootNode.getArea(), rect))
+    item.m_worldBounds = entity.getComponent<xy::Transform>().getWorldTransform().transformRect(item.m_area);
+    if (Util::Rectangle::contains(m_rootNode.getArea(), item.m_worldBounds))
     {
         m_rootNode.addEntity(entity);
         item.m_node->update(entity);
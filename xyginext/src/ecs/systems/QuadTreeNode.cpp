@@ -88,7 +88,7 @@ void QuadTreeNode::update(xy::Entity entity)
     m_entities.erase(std::remove(m_entities.begin(), m_entities.end(), entity), m_entities.end());
     entity.getComponent<xy::QuadTreeItem>().m_node = nullptr;
 
-    auto entBounds = entity.getComponent<xy::Transform>().getWorldTransform().transformRect(entity.getComponent<xy::QuadTreeItem>().m_area);
+    const auto entBounds = entity.getComponent<xy::QuadTreeItem>().m_worldBounds;
 
     auto* currentNode = this;
     while (currentNode)
@@ -266,7 +266,7 @@ void QuadTreeNode::getSubEntities()
 
 sf::Vector2i QuadTreeNode::getPossiblePosition(xy::Entity entity) const
 {
-    auto bounds = entity.getComponent<Transform>().getWorldTransform().transformRect(entity.getComponent<QuadTreeItem>().m_area);
+    const auto bounds = entity.getComponent<QuadTreeItem>().m_worldBounds;
 
     auto boundsCentre = Util::Rectangle::centre(bounds);
     auto areaCentre = Util::Rectangle::centre(m_area);
@@ -291,7 +291,7 @@ bool QuadTreeNode::addToChildren(xy::Entity entity)
     auto position = getPossiblePosition(entity);
     auto child = m_childNodes[position.x + position.y * 2].get();
 
-    auto bounds = entity.getComponent<Transform>().getWorldTransform().transformRect(entity.getComponent<QuadTreeItem>().m_area);
+    const auto bounds = entity.getComponent<QuadTreeItem>().m_worldBounds;
 
     if (Util::Rectangle::contains(child->m_area, bounds))
     {
@@ -29,14 +29,72 @@ source distribution.
 
 #include <xyginext/ecs/components/Transform.hpp>
 #include <xyginext/ecs/components/Drawable.hpp>
+#include <xyginext/core/Assert.hpp>
 
 #include <SFML/Graphics/RenderStates.hpp>
 #include <SFML/Graphics/RenderTarget.hpp>
 
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    //the depth takes the upper 32 bits of the sort key, with
+    //the remaining bits shared between the render state IDs
+    const sf::Uint64 TextureBits = 14;
+    const sf::Uint64 ShaderBits = 9;
+    const sf::Uint64 BlendBits = 9;
+
+    //below this many changed entries (or when the square of the count is less
+    //than the total) changes are merged in to the existing order, else all
+    //entries are radix sorted
+    const std::size_t MinRadixSortCount = 32;
+
+    //drawables covering more grid cells than this are
+    //tested every frame instead of being added to cells
+    const sf::Int64 MaxCellsPerEntity = 16;
+
+    sf::Uint64 getCellKey(sf::Int32 x, sf::Int32 y)
+    {
+        return (static_cast<sf::Uint64>(static_cast<sf::Uint32>(x)) << 32) | static_cast<sf::Uint32>(y);
+    }
+
+    //IDs wrap around if there are more states than bits, which only
+    //affects how well drawables are batched, not their depth order
+    sf::Uint64 getID(std::unordered_map<const void*, sf::Uint32>& ids, const void* ptr, sf::Uint64 bits)
+    {
+        if (!ptr)
+        {
+            return 0;
+        }
+
+        const auto nextID = static_cast<sf::Uint32>(ids.size() + 1);
+        const auto id = ids.insert(std::make_pair(ptr, nextID)).first->second;
+        return id & ((1ull << bits) - 1);
+    }
+
+    //primitives in these arrays are independent of each other, so
+    //arrays can be joined without adding any extra geometry
+    bool canBatch(sf::PrimitiveType type)
+    {
+        return type == sf::Points || type == sf::Lines
+            || type == sf::Triangles || type == sf::Quads;
+    }
+}
+
 
 xy::RenderSystem::RenderSystem(xy::MessageBus& mb)
-    : xy::System(mb, typeid(xy::RenderSystem)),
-    m_wantsSorting(true)
+    : xy::System        (mb, typeid(xy::RenderSystem)),
+    m_batchingEnabled   (true),
+    m_sortedCount       (0),
+    m_cullingEnabled    (false),
+    m_cellSize          (256.f),
+    m_drawOrderChanged  (false),
+    m_queryID           (0),
+    m_drawCallCount     (0),
+    m_vertexCount       (0),
+    m_visibleCount      (0)
 {
     requireComponent<xy::Drawable>();
     requireComponent<xy::Transform>();
@@ -45,34 +103,440 @@ xy::RenderSystem::RenderSystem(xy::MessageBus& mb)
 //public
 void xy::RenderSystem::process(float)
 {
-    auto& entities = getEntities();
-    for (auto& entity : entities)
+    //drop entries for removed entities and pull out any entries
+    //whose sort key changed, leaving the rest in sorted order
+    m_changedEntries.clear();
+    const bool listChanged = !m_removedEntities.empty();
+    std::size_t count = 0;
+    for (auto i = 0u; i < m_drawList.size(); ++i)
     {
-        auto& drawable = entity.getComponent<xy::Drawable>();
-        if (drawable.m_wantsSorting)
+        auto entry = m_drawList[i];
+        if (!m_removedEntities.empty()
+            && m_removedEntities.count(entry.entity.getHandle()) != 0)
+        {
+            if (m_cullingEnabled)
+            {
+                removeFromGrid(entry.entity.getIndex());
+            }
+            continue;
+        }
+
+        auto& drawable = entry.entity.getComponent<xy::Drawable>();
+        if (m_cullingEnabled && drawable.m_boundsChanged)
+        {
+            drawable.m_boundsChanged = false;
+            markDirty(entry.entity);
+        }
+
+        if (drawable.m_wantsSorting || i >= m_sortedCount)
         {
             drawable.m_wantsSorting = false;
-            m_wantsSorting = true;
+
+            const auto key = getSortKey(drawable);
+            if (key != entry.key || i >= m_sortedCount)
+            {
+                entry.key = key;
+                m_changedEntries.push_back(entry);
+                continue;
+            }
         }
+        m_drawList[count++] = entry;
     }
+    m_drawList.resize(count);
+    m_removedEntities.clear();
 
-    //do Z sorting
-    if (m_wantsSorting)
+    if (!m_changedEntries.empty())
     {
-        m_wantsSorting = false;
+        const auto changedCount = m_changedEntries.size();
+        if (changedCount < MinRadixSortCount
+            || changedCount * changedCount < m_drawList.size())
+        {
+            mergeChanged();
+        }
+        else
+        {
+            m_drawList.insert(m_drawList.end(), m_changedEntries.begin(), m_changedEntries.end());
+            radixSort();
+        }
+    }
+    m_sortedCount = m_drawList.size();
+    m_drawOrderChanged = m_drawOrderChanged || listChanged || !m_changedEntries.empty();
+
+    if (m_cullingEnabled)
+    {
+        //transforms updated at the end of the last Scene update
+        for (auto entity : getChanged<xy::Transform>())
+        {
+            markDirty(entity);
+        }
+    }
+}
+
+void xy::RenderSystem::setSpatialCullingEnabled(bool enabled, float cellSize)
+{
+    XY_ASSERT(cellSize > 0, "Cell size must be greater than zero");
+
+    m_cullingEnabled = enabled;
+    m_cellSize = cellSize;
 
-        std::sort(entities.begin(), entities.end(),
-            [](const Entity& entA, const Entity& entB)
+    m_cullingInfo.clear();
+    m_cells.clear();
+    m_largeEntities.clear();
+    m_dirtyEntities.clear();
+
+    if (enabled)
+    {
+        for (const auto& entry : m_drawList)
         {
-            return entA.getComponent<xy::Drawable>().getDepth() < entB.getComponent<xy::Drawable>().getDepth();
-        });
+            markDirty(entry.entity);
+        }
+        m_drawOrderChanged = true;
     }
 }
 
 //private
-void xy::RenderSystem::onEntityAdded(xy::Entity)
+void xy::RenderSystem::onEntityAdded(xy::Entity entity)
 {
-    m_wantsSorting = true;
+    if (m_cullingEnabled)
+    {
+        markDirty(entity);
+        m_drawOrderChanged = true;
+    }
+
+    //an entity removed and added again in the same frame still has its entry
+    if (m_removedEntities.erase(entity.getHandle()) != 0)
+    {
+        entity.getComponent<xy::Drawable>().m_wantsSorting = true;
+        return;
+    }
+
+    DrawEntry entry;
+    entry.entity = entity;
+    m_drawList.push_back(entry);
+}
+
+void xy::RenderSystem::onEntityRemoved(xy::Entity entity)
+{
+    //entries are removed in bulk during the next process()
+    m_removedEntities.insert(entity.getHandle());
+}
+
+sf::Uint64 xy::RenderSystem::getSortKey(const xy::Drawable& drawable)
+{
+    //flipping the sign bit makes negative depths sort before positive ones
+    const sf::Uint64 depth = static_cast<sf::Uint32>(drawable.m_zDepth) ^ 0x80000000u;
+    const auto texture = getID(m_textureIDs, drawable.m_states.texture, TextureBits);
+    const auto shader = getID(m_shaderIDs, drawable.m_states.shader, ShaderBits);
+
+    auto result = std::find(m_blendModes.begin(), m_blendModes.end(), drawable.m_states.blendMode);
+    if (result == m_blendModes.end())
+    {
+        m_blendModes.push_back(drawable.m_states.blendMode);
+        result = m_blendModes.end() - 1;
+    }
+    const auto blend = static_cast<sf::Uint64>(std::distance(m_blendModes.begin(), result)) & ((1ull << BlendBits) - 1);
+
+    return (depth << 32) | (texture << (ShaderBits + BlendBits)) | (shader << BlendBits) | blend;
+}
+
+void xy::RenderSystem::mergeChanged()
+{
+    //only a few entries changed so an insertion sort is quickest...
+    for (auto i = 1u; i < m_changedEntries.size(); ++i)
+    {
+        const auto entry = m_changedEntries[i];
+        auto j = i;
+        for (; j > 0 && m_changedEntries[j - 1].key > entry.key; --j)
+        {
+            m_changedEntries[j] = m_changedEntries[j - 1];
+        }
+        m_changedEntries[j] = entry;
+    }
+
+    //...then merging from the back moves each sorted entry at most once
+    auto sorted = m_drawList.size();
+    auto changed = m_changedEntries.size();
+    m_drawList.resize(sorted + changed);
+
+    auto dest = m_drawList.size();
+    while (changed > 0)
+    {
+        if (sorted > 0 && m_drawList[sorted - 1].key > m_changedEntries[changed - 1].key)
+        {
+            m_drawList[--dest] = m_drawList[--sorted];
+        }
+        else
+        {
+            m_drawList[--dest] = m_changedEntries[--changed];
+        }
+    }
+}
+
+void xy::RenderSystem::radixSort()
+{
+    //LSD radix sort, one byte of the key per pass
+    const std::size_t PassCount = sizeof(sf::Uint64);
+    std::array<std::array<std::size_t, 256>, PassCount> histograms = {};
+    for (const auto& entry : m_drawList)
+    {
+        for (auto pass = 0u; pass < PassCount; ++pass)
+        {
+            histograms[pass][(entry.key >> (pass * 8)) & 0xff]++;
+        }
+    }
+
+    const auto count = m_drawList.size();
+    m_sortBuffer.resize(count);
+    auto* src = &m_drawList;
+    auto* dst = &m_sortBuffer;
+
+    for (auto pass = 0u; pass < PassCount; ++pass)
+    {
+        const auto shift = pass * 8;
+        auto& histogram = histograms[pass];
+
+        //skip passes where every key has the same digit, such as the
+        //upper bytes of the depth, as they won't change the order
+        if (histogram[(src->front().key >> shift) & 0xff] == count)
+        {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (auto& bucket : histogram)
+        {
+            const auto size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+
+        for (const auto& entry : *src)
+        {
+            (*dst)[histogram[(entry.key >> shift) & 0xff]++] = entry;
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != &m_drawList)
+    {
+        m_drawList.swap(m_sortBuffer);
+    }
+}
+
+void xy::RenderSystem::markDirty(xy::Entity entity)
+{
+    const auto index = entity.getIndex();
+    if (index >= m_cullingInfo.size())
+    {
+        m_cullingInfo.resize(index + 1);
+    }
+
+    if (!m_cullingInfo[index].dirty)
+    {
+        m_cullingInfo[index].dirty = true;
+        m_dirtyEntities.push_back(entity);
+    }
+}
+
+void xy::RenderSystem::updateCulling()
+{
+    //transforms updated since the system was processed
+    for (auto entity : getChanged<xy::Transform>())
+    {
+        markDirty(entity);
+    }
+
+    //as are the bounds of any drawables marked as changed since then
+    for (auto entity : getChanged<xy::Drawable>())
+    {
+        auto& drawable = entity.getComponent<xy::Drawable>();
+        if (drawable.m_boundsChanged)
+        {
+            drawable.m_boundsChanged = false;
+            markDirty(entity);
+        }
+    }
+
+    for (auto entity : m_dirtyEntities)
+    {
+        if (!hasEntity(entity))
+        {
+            continue;
+        }
+
+        const auto index = entity.getIndex();
+        auto& info = m_cullingInfo[index];
+        info.dirty = false;
+
+        const auto& drawable = entity.getComponent<xy::Drawable>();
+        const auto& tx = entity.getComponent<xy::Transform>();
+        info.bounds = tx.getWorldTransform().transformRect(drawable.getLocalBounds());
+
+        const auto left = static_cast<sf::Int32>(std::floor(info.bounds.left / m_cellSize));
+        const auto top = static_cast<sf::Int32>(std::floor(info.bounds.top / m_cellSize));
+        const auto right = static_cast<sf::Int32>(std::floor((info.bounds.left + info.bounds.width) / m_cellSize));
+        const auto bottom = static_cast<sf::Int32>(std::floor((info.bounds.top + info.bounds.height) / m_cellSize));
+
+        //most moving drawables stay in the same cells between frames
+        if (info.location != CullingInfo::None
+            && left == info.left && top == info.top
+            && right == info.right && bottom == info.bottom)
+        {
+            continue;
+        }
+
+        removeFromGrid(index);
+        info.left = left;
+        info.top = top;
+        info.right = right;
+        info.bottom = bottom;
+        addToGrid(index);
+    }
+    m_dirtyEntities.clear();
+
+    if (m_drawOrderChanged)
+    {
+        for (auto i = 0u; i < m_drawList.size(); ++i)
+        {
+            const auto index = m_drawList[i].entity.getIndex();
+            if (index < m_cullingInfo.size())
+            {
+                m_cullingInfo[index].drawIndex = i;
+            }
+        }
+        m_drawOrderChanged = false;
+    }
+}
+
+void xy::RenderSystem::addToGrid(sf::Uint32 index)
+{
+    auto& info = m_cullingInfo[index];
+    const sf::Int64 cellCount = static_cast<sf::Int64>(info.right - info.left + 1) * (info.bottom - info.top + 1);
+    if (cellCount > MaxCellsPerEntity)
+    {
+        info.location = CullingInfo::Large;
+        m_largeEntities.push_back(index);
+        return;
+    }
+
+    info.location = CullingInfo::Cells;
+    for (auto y = info.top; y <= info.bottom; ++y)
+    {
+        for (auto x = info.left; x <= info.right; ++x)
+        {
+            m_cells[getCellKey(x, y)].push_back(index);
+        }
+    }
+}
+
+void xy::RenderSystem::removeFromGrid(sf::Uint32 index)
+{
+    if (index >= m_cullingInfo.size())
+    {
+        return;
+    }
+
+    auto remove = [index](std::vector<sf::Uint32>& list)
+    {
+        auto result = std::find(list.begin(), list.end(), index);
+        if (result != list.end())
+        {
+            *result = list.back();
+            list.pop_back();
+        }
+    };
+
+    auto& info = m_cullingInfo[index];
+    if (info.location == CullingInfo::Large)
+    {
+        remove(m_largeEntities);
+    }
+    else if (info.location == CullingInfo::Cells)
+    {
+        for (auto y = info.top; y <= info.bottom; ++y)
+        {
+            for (auto x = info.left; x <= info.right; ++x)
+            {
+                auto cell = m_cells.find(getCellKey(x, y));
+                if (cell != m_cells.end())
+                {
+                    remove(cell->second);
+                    if (cell->second.empty())
+                    {
+                        m_cells.erase(cell);
+                    }
+                }
+            }
+        }
+    }
+    info.location = CullingInfo::None;
+
+    //any pending update belonged to the removed entity,
+    //and mustn't stop a new entity with this index being added
+    info.dirty = false;
+}
+
+void xy::RenderSystem::queryGrid(const sf::FloatRect& area)
+{
+    m_visibleEntries.clear();
+    m_queryID++;
+
+    //drawables covering more than one cell are only tested once
+    auto test = [&](sf::Uint32 index)
+    {
+        auto& info = m_cullingInfo[index];
+        if (info.queryID != m_queryID)
+        {
+            info.queryID = m_queryID;
+            if (info.bounds.intersects(area))
+            {
+                m_visibleEntries.push_back(info.drawIndex);
+            }
+        }
+    };
+
+    const auto left = static_cast<sf::Int32>(std::floor(area.left / m_cellSize));
+    const auto top = static_cast<sf::Int32>(std::floor(area.top / m_cellSize));
+    const auto right = static_cast<sf::Int32>(std::floor((area.left + area.width) / m_cellSize));
+    const auto bottom = static_cast<sf::Int32>(std::floor((area.top + area.height) / m_cellSize));
+
+    //when zoomed out it's quicker to visit the occupied cells than every cell in the view
+    const sf::Int64 cellCount = static_cast<sf::Int64>(right - left + 1) * (bottom - top + 1);
+    if (cellCount > static_cast<sf::Int64>(m_cells.size()))
+    {
+        for (const auto& cell : m_cells)
+        {
+            for (auto index : cell.second)
+            {
+                test(index);
+            }
+        }
+    }
+    else
+    {
+        for (auto y = top; y <= bottom; ++y)
+        {
+            for (auto x = left; x <= right; ++x)
+            {
+                auto cell = m_cells.find(getCellKey(x, y));
+                if (cell != m_cells.end())
+                {
+                    for (auto index : cell->second)
+                    {
+                        test(index);
+                    }
+                }
+            }
+        }
+    }
+
+    for (auto index : m_largeEntities)
+    {
+        test(index);
+    }
+
+    //visible drawables are found in any order, so put them back in to depth order
+    std::sort(m_visibleEntries.begin(), m_visibleEntries.end());
 }
 
 void xy::RenderSystem::draw(sf::RenderTarget& rt, sf::RenderStates states) const
@@ -80,16 +544,99 @@ void xy::RenderSystem::draw(sf::RenderTarget& rt, sf::RenderStates states) const
     auto view = rt.getView();
     sf::FloatRect viewableArea(view.getCenter() - (view.getSize() / 2.f), view.getSize());
 
-    for (auto entity : getEntities())
+    m_drawCallCount = 0;
+    m_vertexCount = 0;
+    m_visibleCount = 0;
+
+    //states and primitive type of the batch currently being built
+    sf::RenderStates batchStates;
+    sf::PrimitiveType batchType = sf::Quads;
+    auto flush = [&]()
     {
-        const auto& drawable = entity.getComponent<xy::Drawable>();
-        const auto& tx = entity.getComponent<xy::Transform>().getWorldTransform();
-        const auto bounds = tx.transformRect(drawable.getLocalBounds());
-        if (bounds.intersects(viewableArea))
+        if (!m_batchVertices.empty())
         {
+            rt.draw(m_batchVertices.data(), m_batchVertices.size(), batchType, batchStates);
+            m_drawCallCount++;
+            m_vertexCount += m_batchVertices.size();
+            m_batchVertices.clear();
+        }
+    };
+
+    auto drawDrawable = [&](const xy::Drawable& drawable, const sf::Transform& tx)
+    {
+        m_visibleCount++;
+
+        if (!m_batchingEnabled || !canBatch(drawable.m_primitiveType))
+        {
+            flush();
+
             states = drawable.m_states;
             states.transform = tx;
             rt.draw(drawable.m_vertices.data(), drawable.m_vertices.size(), drawable.m_primitiveType, states);
+            m_drawCallCount++;
+            m_vertexCount += drawable.m_vertices.size();
+            return;
+        }
+
+        if (!m_batchVertices.empty()
+            && (drawable.m_primitiveType != batchType
+                || drawable.m_states.texture != batchStates.texture
+                || drawable.m_states.shader != batchStates.shader
+                || drawable.m_states.blendMode != batchStates.blendMode))
+        {
+            flush();
+        }
+
+        if (m_batchVertices.empty())
+        {
+            batchStates = drawable.m_states;
+            batchStates.transform = sf::Transform::Identity;
+            batchType = drawable.m_primitiveType;
+        }
+
+        for (auto vertex : drawable.m_vertices)
+        {
+            vertex.position = tx.transformPoint(vertex.position);
+            m_batchVertices.push_back(vertex);
+        }
+    };
+
+    if (m_cullingEnabled)
+    {
+        //the grid is updated here rather than in process() as world
+        //transforms are only final once the Scene has finished updating
+        auto& self = const_cast<RenderSystem&>(*this);
+        self.updateCulling();
+        self.queryGrid(viewableArea);
+
+        for (auto i : m_visibleEntries)
+        {
+            const auto entity = m_drawList[i].entity;
+            const auto& drawable = entity.getComponent<xy::Drawable>();
+            if (!drawable.m_vertices.empty())
+            {
+                drawDrawable(drawable, entity.getComponent<xy::Transform>().getWorldTransform());
+            }
+        }
+    }
+    else
+    {
+        for (const auto& entry : m_drawList)
+        {
+            const auto entity = entry.entity;
+            const auto& drawable = entity.getComponent<xy::Drawable>();
+            if (drawable.m_vertices.empty())
+            {
+                continue;
+            }
+
+            const auto& tx = entity.getComponent<xy::Transform>().getWorldTransform();
+            const auto bounds = tx.transformRect(drawable.getLocalBounds());
+            if (bounds.intersects(viewableArea))
+            {
+                drawDrawable(drawable, tx);
+            }
         }
     }
+    flush();
 }
\ No newline at end of file
@@ -38,18 +38,18 @@ SpriteAnimator::SpriteAnimator(MessageBus& mb)
 {
     requireComponent<Sprite>();
     requireComponent<SpriteAnimation>();
+
+    writesComponent<Sprite>();
+    writesComponent<SpriteAnimation>();
 }
 
 //public
 void SpriteAnimator::process(float dt)
 {
-    auto& entities = getEntities();
-    for (auto& entity : entities) 
+    view<Sprite, SpriteAnimation>().each([dt](Entity entity, Sprite& sprite, SpriteAnimation& animation)
     {
-        auto& animation = entity.getComponent<SpriteAnimation>();
         if (animation.m_playing)
         {
-            auto& sprite = entity.getComponent<Sprite>();
             animation.m_currentFrameTime -= dt;
             if (animation.m_currentFrameTime < 0 && sprite.m_animations[animation.m_id].frameCount > 0)
             {
@@ -63,11 +63,12 @@ void SpriteAnimator::process(float dt)
                 if (animation.m_frameID < lastFrame && !sprite.m_animations[animation.m_id].looped)
                 {
                     animation.stop();
-                    continue;
+                    return;
                 }
 
                 sprite.setTextureRect(sprite.m_animations[animation.m_id].frames[animation.m_frameID]);
+                entity.markChanged<Sprite>(); //views don't track changes
             }
         }
-    }
+    });
 }
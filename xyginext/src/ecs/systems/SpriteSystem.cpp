@@ -30,6 +30,8 @@ source distribution.
 #include <xyginext/ecs/components/Drawable.hpp>
 #include <xyginext/ecs/systems/SpriteSystem.hpp>
 
+#include <xyginext/core/JobSystem.hpp>
+
 using namespace xy;
 
 namespace
@@ -44,47 +46,71 @@ SpriteSystem::SpriteSystem(MessageBus& mb)
     //requireComponent<xy::Transform>();
     requireComponent<xy::Sprite>();
     requireComponent<xy::Drawable>();
+
+    writesComponent<xy::Sprite>();
+    writesComponent<xy::Drawable>();
 }
 
 //public
 void SpriteSystem::process(float)
 {
-    //update geometry
-    auto& entities = getEntities();
-    for (auto& entity : entities)
+    //update geometry of modified sprites - each sprite only touches
+    //its own drawable so the entities can be split across threads
+    const auto& changed = getChanged<xy::Sprite>();
+    auto sprites = view<xy::Sprite, xy::Drawable>(changed);
+    JobSystem::parallelFor(sprites.size(), [&sprites](std::size_t start, std::size_t end)
     {
-        auto& sprite = entity.getComponent<xy::Sprite>();
-        if (sprite.m_dirty)
+        for (auto i = start; i < end; ++i)
         {
-            auto& drawable = entity.getComponent<xy::Drawable>();
-            //drawable.setPrimitiveType(sf::TriangleStrip);
+            auto components = sprites[i];
+            auto& sprite = std::get<0>(components);
+            if (sprite.m_dirty)
+            {
+                auto& drawable = std::get<1>(components);
+                //drawable.setPrimitiveType(sf::TriangleStrip);
             
-            //update vert positions
-            const auto subRect = sprite.m_textureRect;
-            auto& verts = drawable.getVertices();
-            verts.resize(4);
-
-            verts[0].position = { 0.f, 0.f };
-            verts[1].position = { subRect.width, 0.f };
-            verts[2].position = { subRect.width, subRect.height };
-            verts[3].position = { 0.f, subRect.height };
-
-            //update vert coords
-            verts[0].texCoords = { subRect.left, subRect.top };
-            verts[1].texCoords = { subRect.left + subRect.width, subRect.top };
-            verts[2].texCoords = { subRect.left + subRect.width, subRect.top + subRect.height };
-            verts[3].texCoords = { subRect.left, subRect.top + subRect.height };
-
-            //update colour
-            verts[0].color = sprite.m_colour;
-            verts[1].color = sprite.m_colour;
-            verts[2].color = sprite.m_colour;
-            verts[3].color = sprite.m_colour;
-
-            drawable.setTexture(sprite.getTexture());
-            drawable.updateLocalBounds();
-
-            sprite.m_dirty = false;
+                //update vert positions
+                const auto subRect = sprite.m_textureRect;
+                auto& verts = drawable.getVertices();
+                verts.resize(4);
+
+                verts[0].position = { 0.f, 0.f };
+                verts[1].position = { subRect.width, 0.f };
+                verts[2].position = { subRect.width, subRect.height };
+                verts[3].position = { 0.f, subRect.height };
+
+                //update vert coords
+                verts[0].texCoords = { subRect.left, subRect.top };
+                verts[1].texCoords = { subRect.left + subRect.width, subRect.top };
+                verts[2].texCoords = { subRect.left + subRect.width, subRect.top + subRect.height };
+                verts[3].texCoords = { subRect.left, subRect.top + subRect.height };
+
+                //update colour
+                verts[0].color = sprite.m_colour;
+                verts[1].color = sprite.m_colour;
+                verts[2].color = sprite.m_colour;
+                verts[3].color = sprite.m_colour;
+
+                drawable.setTexture(sprite.getTexture());
+                drawable.updateLocalBounds();
+
+                sprite.m_dirty = false;
+            }
         }
+    });
+
+    //so the RenderSystem culls with the new bounds even if it has
+    //already been processed this frame
+    for (auto entity : changed)
+    {
+        entity.markChanged<xy::Drawable>();
     }
 }
+
+//private
+void SpriteSystem::onEntityAdded(Entity entity)
+{
+    //the sprite may have been created before the entity had a
+    //drawable, so make sure the geometry is built at least once
+    entity.markChanged<xy::Sprite>();
+}
@@ -70,15 +70,10 @@ void TextRenderer::process(float)
         vertices.push_back(sf::Vertex(sf::Vector2f(position.x + right, position.y + bottom), colour, sf::Vector2f(u2, v2)));
     };
 
-    auto& entities = getEntities();
-    m_texts.clear();
-    m_texts.reserve(entities.size());
-    m_croppedTexts.clear();
-    m_croppedTexts.reserve(entities.size());
-
-    for (auto& entity : entities)
+    //only texts which have been modified need their geometry rebuilding
+    for (auto components : view<Text>(getChanged<Text>()))
     {
-        auto& text = entity.getComponent<Text>();
+        auto& text = std::get<0>(components);
         if (text.m_dirty)
         {
             text.m_dirty = false;
@@ -185,9 +180,23 @@ void TextRenderer::process(float)
             //use the local bounds to see if we want cropping or not
             text.m_cropped = !Util::Rectangle::contains(text.m_croppingArea, text.m_localBounds);
         }
+    }
 
-        //TODO - shouldn't this be in the dirty loop above?
-        const auto& xForm = entity.getComponent<Transform>().getWorldTransform();
+    const auto& entities = getEntities();
+    m_texts.clear();
+    m_texts.reserve(entities.size());
+    m_croppedTexts.clear();
+    m_croppedTexts.reserve(entities.size());
+
+    //world positions are updated every frame as the transform may have moved
+    view<Transform, Text>().each([this](Entity entity, const Transform& tx, Text& text)
+    {
+        if (text.m_vertices.empty())
+        {
+            return; //nothing to draw
+        }
+
+        const auto& xForm = tx.getWorldTransform();
 
         //update world positions
         text.m_croppingWorldArea = xForm.transformRect(text.m_croppingArea);
@@ -198,7 +207,15 @@ void TextRenderer::process(float)
 
         //assign to relevant array
         (text.m_cropped) ? m_croppedTexts.push_back(entity) : m_texts.push_back(entity);
-    }
+    });
+}
+
+//private
+void TextRenderer::onEntityAdded(Entity entity)
+{
+    //the text may have been created long before it was added
+    //to this system, so make sure its geometry is built
+    entity.markChanged<Text>();
 }
 
 void TextRenderer::draw(sf::RenderTarget& rt, sf::RenderStates states) const
@@ -0,0 +1,343 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/ecs/systems/TileMapSystem.hpp>
+#include <xyginext/ecs/components/TileMap.hpp>
+#include <xyginext/ecs/components/Transform.hpp>
+#include <xyginext/core/Log.hpp>
+
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+using namespace xy;
+
+namespace
+{
+    const sf::Uint32 FlipMask = TileMap::Horizontal | TileMap::Vertical | TileMap::Diagonal;
+
+    //returns the tileset count if the ID isn't in any tileset
+    std::size_t findTileset(const std::vector<TileMap::Tileset>& tilesets, sf::Uint32 id)
+    {
+        for (auto i = 0u; i < tilesets.size(); ++i)
+        {
+            if (id >= tilesets[i].firstID && id < tilesets[i].firstID + tilesets[i].tileCount)
+            {
+                return i;
+            }
+        }
+        return tilesets.size();
+    }
+
+    //texture coordinates of the top left, top right, bottom right
+    //and bottom left corners of a tile, in that order
+    std::array<sf::Vector2f, 4u> getTexCoords(const TileMap::Tileset& tileset, sf::Uint32 id, sf::Uint32 flags)
+    {
+        const auto index = id - tileset.firstID;
+        const auto left = static_cast<float>(tileset.margin + (index % tileset.columns) * (tileset.tileSize.x + tileset.spacing));
+        const auto top = static_cast<float>(tileset.margin + (index / tileset.columns) * (tileset.tileSize.y + tileset.spacing));
+        const auto right = left + tileset.tileSize.x;
+        const auto bottom = top + tileset.tileSize.y;
+
+        std::array<sf::Vector2f, 4u> coords =
+        {
+            {
+                { left, top },
+                { right, top },
+                { right, bottom },
+                { left, bottom }
+            }
+        };
+
+        //same order as Tiled applies them
+        if (flags & TileMap::Diagonal)
+        {
+            std::swap(coords[1], coords[3]);
+        }
+        if (flags & TileMap::Horizontal)
+        {
+            std::swap(coords[0], coords[1]);
+            std::swap(coords[2], coords[3]);
+        }
+        if (flags & TileMap::Vertical)
+        {
+            std::swap(coords[0], coords[3]);
+            std::swap(coords[1], coords[2]);
+        }
+        return coords;
+    }
+}
+
+TileMapSystem::TileMapSystem(MessageBus& mb)
+    : System            (mb, typeid(TileMapSystem)),
+    m_drawnChunkCount   (0)
+{
+    requireComponent<TileMap>();
+    requireComponent<Transform>();
+}
+
+//public
+void TileMapSystem::process(float dt)
+{
+    m_maps.clear();
+    view<TileMap>().each([&](Entity entity, TileMap& map)
+    {
+        if (map.m_dirty)
+        {
+            build(map);
+        }
+        updateAnimations(map, dt);
+
+        m_maps.push_back(entity);
+    });
+}
+
+//private
+void TileMapSystem::build(TileMap& map)
+{
+    map.m_chunks.clear();
+
+    //animated tiles are found while building the chunks, and
+    //only animations with all frames in one tileset are used
+    std::vector<bool> validAnimations(map.m_animations.size(), false);
+    for (const auto& pair : map.m_animationIndices)
+    {
+        auto& animation = map.m_animations[pair.second];
+        animation.tiles.clear();
+        animation.currentFrame = 0;
+        animation.elapsed = 0.f;
+
+        const auto tileset = findTileset(map.m_tilesets, pair.first);
+        validAnimations[pair.second] = std::all_of(animation.frames.begin(), animation.frames.end(),
+            [&](const TileMap::AnimationFrame& frame)
+        {
+            return findTileset(map.m_tilesets, frame.tileID) == tileset;
+        });
+
+        if (!validAnimations[pair.second])
+        {
+            Logger::log("Animation for tile " + std::to_string(pair.first) + " uses more than one tileset", Logger::Type::Warning);
+        }
+    }
+
+    const auto chunkSize = map.m_chunkSize;
+    const auto tileSize = map.m_tileSize;
+
+    for (const auto& layer : map.m_layers)
+    {
+        for (auto chunkY = 0u; chunkY < layer.size.y; chunkY += chunkSize.y)
+        {
+            for (auto chunkX = 0u; chunkX < layer.size.x; chunkX += chunkSize.x)
+            {
+                const auto firstChunk = map.m_chunks.size();
+                const auto endX = std::min(layer.size.x, chunkX + chunkSize.x);
+                const auto endY = std::min(layer.size.y, chunkY + chunkSize.y);
+                const sf::FloatRect bounds(chunkX * tileSize.x, chunkY * tileSize.y,
+                                            (endX - chunkX) * tileSize.x, (endY - chunkY) * tileSize.y);
+
+                for (auto y = chunkY; y < endY; ++y)
+                {
+                    for (auto x = chunkX; x < endX; ++x)
+                    {
+                        const auto tile = layer.tiles[y * layer.size.x + x];
+                        const auto flags = tile & FlipMask;
+                        auto id = tile & ~FlipMask;
+                        if (id == 0)
+                        {
+                            continue;
+                        }
+
+                        const auto tileset = findTileset(map.m_tilesets, id);
+                        if (tileset == map.m_tilesets.size())
+                        {
+                            continue;
+                        }
+
+                        //one vertex array for each tileset used in this part of the layer
+                        auto chunkIndex = firstChunk;
+                        while (chunkIndex < map.m_chunks.size() && map.m_chunks[chunkIndex].tileset != tileset)
+                        {
+                            chunkIndex++;
+                        }
+                        if (chunkIndex == map.m_chunks.size())
+                        {
+                            map.m_chunks.emplace_back();
+                            map.m_chunks.back().bounds = bounds;
+                            map.m_chunks.back().tileset = tileset;
+                        }
+                        auto& chunk = map.m_chunks[chunkIndex];
+
+                        auto animation = map.m_animationIndices.find(id);
+                        if (animation != map.m_animationIndices.end()
+                            && validAnimations[animation->second])
+                        {
+                            TileMap::AnimatedTile animatedTile;
+                            animatedTile.chunk = chunkIndex;
+                            animatedTile.vertex = chunk.vertices.size();
+                            animatedTile.flags = flags;
+
+                            auto& tileAnimation = map.m_animations[animation->second];
+                            tileAnimation.tiles.push_back(animatedTile);
+                            id = tileAnimation.frames[0].tileID;
+                            chunk.animated = true;
+                        }
+
+                        const sf::Vector2f position(x * tileSize.x, y * tileSize.y);
+                        const auto texCoords = getTexCoords(map.m_tilesets[tileset], id, flags);
+                        chunk.vertices.emplace_back(position, texCoords[0]);
+                        chunk.vertices.emplace_back(sf::Vector2f(position.x + tileSize.x, position.y), texCoords[1]);
+                        chunk.vertices.emplace_back(position + tileSize, texCoords[2]);
+                        chunk.vertices.emplace_back(sf::Vector2f(position.x, position.y + tileSize.y), texCoords[3]);
+                    }
+                }
+            }
+        }
+    }
+
+    for (auto& chunk : map.m_chunks)
+    {
+        chunk.dirtyStart = 0;
+        chunk.dirtyEnd = chunk.vertices.size();
+    }
+    map.m_dirty = false;
+}
+
+void TileMapSystem::updateAnimations(TileMap& map, float dt)
+{
+    for (auto& animation : map.m_animations)
+    {
+        if (animation.tiles.empty() || animation.frames.size() < 2
+            || !(animation.duration > 0.f))
+        {
+            continue;
+        }
+
+        //whole cycles are skipped so that a long frame time, or very
+        //short frames, never take more than one pass over the frames
+        auto frame = animation.currentFrame;
+        animation.elapsed += dt;
+        if (animation.elapsed >= animation.duration)
+        {
+            animation.elapsed = std::fmod(animation.elapsed, animation.duration);
+        }
+
+        for (auto i = 0u; i < animation.frames.size()
+            && animation.elapsed >= animation.frames[frame].duration; ++i)
+        {
+            animation.elapsed -= animation.frames[frame].duration;
+            frame = (frame + 1) % animation.frames.size();
+        }
+
+        if (frame == animation.currentFrame)
+        {
+            continue;
+        }
+        animation.currentFrame = frame;
+
+        //only the vertices of the animated tiles are touched
+        const auto id = animation.frames[frame].tileID;
+        for (const auto& tile : animation.tiles)
+        {
+            auto& chunk = map.m_chunks[tile.chunk];
+            const auto texCoords = getTexCoords(map.m_tilesets[chunk.tileset], id, tile.flags);
+            for (auto i = 0u; i < texCoords.size(); ++i)
+            {
+                chunk.vertices[tile.vertex + i].texCoords = texCoords[i];
+            }
+
+            if (chunk.dirtyStart == chunk.dirtyEnd)
+            {
+                chunk.dirtyStart = tile.vertex;
+                chunk.dirtyEnd = tile.vertex + texCoords.size();
+            }
+            else
+            {
+                chunk.dirtyStart = std::min(chunk.dirtyStart, tile.vertex);
+                chunk.dirtyEnd = std::max(chunk.dirtyEnd, tile.vertex + texCoords.size());
+            }
+        }
+    }
+}
+
+void TileMapSystem::draw(sf::RenderTarget& rt, sf::RenderStates states) const
+{
+    auto view = rt.getView();
+    sf::FloatRect viewableArea(view.getCenter() - (view.getSize() / 2.f), view.getSize());
+
+    m_drawnChunkCount = 0;
+
+#ifdef XY_TILEMAP_VERTEX_BUFFER
+    const bool useBuffers = sf::VertexBuffer::isAvailable();
+#endif //XY_TILEMAP_VERTEX_BUFFER
+
+    for (auto entity : m_maps)
+    {
+        auto& map = entity.getComponent<TileMap>();
+        states.transform = entity.getComponent<Transform>().getWorldTransform();
+
+        for (auto& chunk : map.m_chunks)
+        {
+            if (chunk.vertices.empty()
+                || !states.transform.transformRect(chunk.bounds).intersects(viewableArea))
+            {
+                continue;
+            }
+            states.texture = map.m_tilesets[chunk.tileset].texture;
+            m_drawnChunkCount++;
+
+#ifdef XY_TILEMAP_VERTEX_BUFFER
+            if (useBuffers)
+            {
+                //buffers are created and updated here rather than in process()
+                //so that it happens on the thread which owns the OpenGL context
+                if (!chunk.buffer)
+                {
+                    chunk.buffer = std::make_unique<sf::VertexBuffer>(sf::Quads,
+                        chunk.animated ? sf::VertexBuffer::Dynamic : sf::VertexBuffer::Static);
+                    chunk.buffer->create(chunk.vertices.size());
+                    chunk.dirtyStart = 0;
+                    chunk.dirtyEnd = chunk.vertices.size();
+                }
+
+                if (chunk.dirtyEnd > chunk.dirtyStart)
+                {
+                    chunk.buffer->update(&chunk.vertices[chunk.dirtyStart], chunk.dirtyEnd - chunk.dirtyStart,
+                                            static_cast<unsigned>(chunk.dirtyStart));
+                    chunk.dirtyStart = chunk.dirtyEnd = 0;
+                }
+                rt.draw(*chunk.buffer, states);
+                continue;
+            }
+#endif //XY_TILEMAP_VERTEX_BUFFER
+
+            rt.draw(chunk.vertices.data(), chunk.vertices.size(), sf::Quads, states);
+        }
+    }
+}
@@ -47,6 +47,7 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
 
     m_sprites.clear();
     m_animations.clear();
+    m_texturePath.clear();
 
     std::size_t count = 0;
 
@@ -56,7 +57,8 @@ bool SpriteSheet::loadFromFile(const std::string& path, TextureResource& texture
     //validate sprites, increase count
     if (auto* p = sheetFile.findProperty("src"))
     {
-        texture = &textures.get(p->getValue<std::string>());
+        m_texturePath = p->getValue<std::string>();
+        texture = &textures.get(m_texturePath);
     }
     else
     {
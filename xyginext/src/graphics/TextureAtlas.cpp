@@ -0,0 +1,441 @@
+/*********************************************************************
+(c) Matt Marchant 2017
+http://trederia.blogspot.com
+
+xygineXT - Zlib license.
+
+This software is provided 'as-is', without any express or
+implied warranty. In no event will the authors be held
+liable for any damages arising from the use of this software.
+
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute
+it freely, subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented;
+you must not claim that you wrote the original software.
+If you use this software in a product, an acknowledgment
+in the product documentation would be appreciated but
+is not required.
+
+2. Altered source versions must be plainly marked as such,
+and must not be misrepresented as being the original software.
+
+3. This notice may not be removed or altered from any
+source distribution.
+*********************************************************************/
+
+#include <xyginext/graphics/TextureAtlas.hpp>
+#include <xyginext/graphics/SpriteSheet.hpp>
+#include <xyginext/ecs/components/Sprite.hpp>
+#include <xyginext/core/ConfigFile.hpp>
+#include <xyginext/core/FileSystem.hpp>
+#include <xyginext/core/Log.hpp>
+#include <xyginext/core/Assert.hpp>
+
+//imgui keeps its copy of the packer private to imgui_draw.cpp
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "../imgui/stb_rect_pack.h"
+
+#include <fstream>
+#include <algorithm>
+
+using namespace xy;
+
+namespace
+{
+    //used to tell if an image file has changed since
+    //the atlas cache was written
+    sf::Int32 getFileSize(const std::string& path)
+    {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.good())
+        {
+            return -1;
+        }
+        return static_cast<sf::Int32>(file.tellg());
+    }
+
+    std::string getPagePath(const std::string& indexPath, std::size_t page)
+    {
+        auto ext = FileSystem::getFileExtension(indexPath);
+        return indexPath.substr(0, indexPath.size() - ext.size()) + "_" + std::to_string(page) + ".png";
+    }
+}
+
+TextureAtlas::TextureAtlas()
+    : m_pageSize    (2048u, 2048u),
+    m_padding       (1u),
+    m_smooth        (false)
+{
+
+}
+
+//public
+void TextureAtlas::setPageSize(sf::Vector2u size)
+{
+    XY_ASSERT(size.x > 0 && size.y > 0, "Invalid page size");
+    XY_ASSERT(size.x <= 0xffff && size.y <= 0xffff, "Page size too large");
+    m_pageSize = size;
+}
+
+void TextureAtlas::setPadding(sf::Uint32 padding)
+{
+    m_padding = padding;
+}
+
+void TextureAtlas::setSmooth(bool smooth)
+{
+    m_smooth = smooth;
+    for (auto& page : m_pages)
+    {
+        page->setSmooth(smooth);
+    }
+}
+
+void TextureAtlas::addImage(const std::string& path)
+{
+    auto result = std::find_if(m_sources.begin(), m_sources.end(),
+        [&path](const Source& s) { return s.name == path; });
+
+    if (result == m_sources.end())
+    {
+        m_sources.emplace_back();
+        m_sources.back().name = path;
+    }
+}
+
+void TextureAtlas::addImage(const std::string& name, const sf::Image& image)
+{
+    auto result = std::find_if(m_sources.begin(), m_sources.end(),
+        [&name](const Source& s) { return s.name == name; });
+
+    if (result == m_sources.end())
+    {
+        m_sources.emplace_back();
+        result = m_sources.end() - 1;
+        result->name = name;
+    }
+    result->image = std::make_unique<sf::Image>(image);
+}
+
+void TextureAtlas::addSpriteSheet(const SpriteSheet& sheet)
+{
+    if (sheet.getTexturePath().empty())
+    {
+        Logger::log("Sprite sheet has no texture, not added to atlas", Logger::Type::Warning);
+        return;
+    }
+    addImage(sheet.getTexturePath());
+}
+
+bool TextureAtlas::pack()
+{
+    m_pages.clear();
+    m_entries.clear();
+
+    const auto maxSize = sf::Texture::getMaximumSize();
+    const sf::Vector2u pageSize(std::min(m_pageSize.x, maxSize), std::min(m_pageSize.y, maxSize));
+
+    bool result = true;
+
+    //images added by path are only loaded for the duration of packing
+    std::vector<sf::Image> loadedImages(m_sources.size());
+    std::vector<const sf::Image*> images(m_sources.size());
+    std::vector<stbrp_rect> rects;
+    rects.reserve(m_sources.size());
+
+    for (auto i = 0u; i < m_sources.size(); ++i)
+    {
+        const auto& source = m_sources[i];
+        if (source.image)
+        {
+            images[i] = source.image.get();
+        }
+        else if (loadedImages[i].loadFromFile(source.name))
+        {
+            images[i] = &loadedImages[i];
+        }
+        else
+        {
+            Logger::log("Failed to load " + source.name + " for texture atlas", Logger::Type::Error);
+            result = false;
+            continue;
+        }
+
+        auto size = images[i]->getSize();
+        size.x += m_padding * 2;
+        size.y += m_padding * 2;
+
+        if (size.x > pageSize.x || size.y > pageSize.y)
+        {
+            Logger::log(source.name + " is too large for texture atlas page", Logger::Type::Error);
+            result = false;
+            continue;
+        }
+
+        stbrp_rect rect;
+        rect.id = static_cast<int>(i);
+        rect.w = static_cast<stbrp_coord>(size.x);
+        rect.h = static_cast<stbrp_coord>(size.y);
+        rect.x = rect.y = 0;
+        rect.was_packed = 0;
+        rects.push_back(rect);
+    }
+
+    //anything which doesn't fit on the current page is carried over to a new one
+    std::vector<stbrp_node> nodes(pageSize.x);
+    while (!rects.empty())
+    {
+        stbrp_context context;
+        stbrp_init_target(&context, pageSize.x, pageSize.y, nodes.data(), static_cast<int>(nodes.size()));
+        stbrp_pack_rects(&context, rects.data(), static_cast<int>(rects.size()));
+
+        //crop the page to the area actually used
+        sf::Vector2u usedSize;
+        for (const auto& rect : rects)
+        {
+            if (rect.was_packed)
+            {
+                usedSize.x = std::max(usedSize.x, static_cast<sf::Uint32>(rect.x + rect.w));
+                usedSize.y = std::max(usedSize.y, static_cast<sf::Uint32>(rect.y + rect.h));
+            }
+        }
+
+        if (usedSize.x == 0)
+        {
+            //every image fits on an empty page, so this shouldn't happen
+            Logger::log("Failed to pack texture atlas page", Logger::Type::Error);
+            return false;
+        }
+
+        const auto page = m_pages.size();
+        sf::Image pageImage;
+        pageImage.create(usedSize.x, usedSize.y, sf::Color::Transparent);
+        for (const auto& rect : rects)
+        {
+            if (rect.was_packed)
+            {
+                const auto& image = *images[rect.id];
+                const sf::Vector2u position(rect.x + m_padding, rect.y + m_padding);
+                pageImage.copy(image, position.x, position.y);
+
+                auto& entry = m_entries[m_sources[rect.id].name];
+                entry.region.page = page;
+                entry.region.bounds = { sf::Vector2i(position), sf::Vector2i(image.getSize()) };
+                entry.fileSize = m_sources[rect.id].image ? -1 : getFileSize(m_sources[rect.id].name);
+            }
+        }
+
+        m_pages.emplace_back(std::make_unique<sf::Texture>());
+        if (!m_pages.back()->loadFromImage(pageImage))
+        {
+            Logger::log("Failed to create texture atlas page", Logger::Type::Error);
+            m_pages.clear();
+            m_entries.clear();
+            return false;
+        }
+        m_pages.back()->setSmooth(m_smooth);
+
+        rects.erase(std::remove_if(rects.begin(), rects.end(),
+            [](const stbrp_rect& r) { return r.was_packed != 0; }), rects.end());
+    }
+
+    LOG("Packed " + std::to_string(m_entries.size()) + " images into " + std::to_string(m_pages.size()) + " atlas pages", Logger::Type::Info);
+    return result;
+}
+
+bool TextureAtlas::saveToFile(const std::string& path) const
+{
+    if (m_pages.empty())
+    {
+        Logger::log("Texture atlas has not been packed, nothing to save", Logger::Type::Error);
+        return false;
+    }
+
+    for (auto i = 0u; i < m_pages.size(); ++i)
+    {
+        if (!m_pages[i]->copyToImage().saveToFile(getPagePath(path, i)))
+        {
+            Logger::log("Failed to save texture atlas page to " + getPagePath(path, i), Logger::Type::Error);
+            return false;
+        }
+    }
+
+    ConfigFile index("texture_atlas");
+    index.addProperty("page_size").setValue(sf::Vector2f(m_pageSize));
+    index.addProperty("padding").setValue(static_cast<sf::Int32>(m_padding));
+    index.addProperty("page_count").setValue(static_cast<sf::Int32>(m_pages.size()));
+
+    for (const auto& entry : m_entries)
+    {
+        auto* obj = index.addObject("image");
+        obj->addProperty("src", "\"" + entry.first + "\"");
+        obj->addProperty("file_size").setValue(entry.second.fileSize);
+        obj->addProperty("page").setValue(static_cast<sf::Int32>(entry.second.region.page));
+        obj->addProperty("bounds").setValue(sf::FloatRect(entry.second.region.bounds));
+    }
+
+    return index.save(path);
+}
+
+bool TextureAtlas::loadFromFile(const std::string& path)
+{
+    ConfigFile index;
+    if (!index.loadFromFile(path))
+    {
+        return false;
+    }
+
+    //a cache written with different settings is considered stale
+    auto* p = index.findProperty("page_size");
+    if (!p || sf::Vector2u(p->getValue<sf::Vector2f>()) != m_pageSize)
+    {
+        return false;
+    }
+
+    p = index.findProperty("padding");
+    if (!p || static_cast<sf::Uint32>(p->getValue<sf::Int32>()) != m_padding)
+    {
+        return false;
+    }
+
+    p = index.findProperty("page_count");
+    if (!p || p->getValue<sf::Int32>() < 1)
+    {
+        return false;
+    }
+    const auto pageCount = static_cast<std::size_t>(p->getValue<sf::Int32>());
+
+    std::unordered_map<std::string, Entry> entries;
+    for (const auto& obj : index.getObjects())
+    {
+        if (obj.getName() == "image")
+        {
+            auto* src = obj.findProperty("src");
+            auto* fileSize = obj.findProperty("file_size");
+            auto* page = obj.findProperty("page");
+            auto* bounds = obj.findProperty("bounds");
+            if (!src || !fileSize || !page || !bounds)
+            {
+                Logger::log(path + ": invalid image entry in texture atlas", Logger::Type::Warning);
+                return false;
+            }
+
+            auto& entry = entries[src->getValue<std::string>()];
+            entry.fileSize = fileSize->getValue<sf::Int32>();
+            entry.region.page = static_cast<std::size_t>(page->getValue<sf::Int32>());
+            entry.region.bounds = sf::IntRect(bounds->getValue<sf::FloatRect>());
+
+            if (entry.region.page >= pageCount)
+            {
+                return false;
+            }
+        }
+    }
+
+    //make sure everything which has been added is in the cache and unchanged
+    for (const auto& source : m_sources)
+    {
+        auto entry = entries.find(source.name);
+        if (entry == entries.end())
+        {
+            return false;
+        }
+
+        if (source.image)
+        {
+            const auto& bounds = entry->second.region.bounds;
+            if (sf::Vector2u(bounds.width, bounds.height) != source.image->getSize())
+            {
+                return false;
+            }
+        }
+        else if (entry->second.fileSize != getFileSize(source.name))
+        {
+            return false;
+        }
+    }
+
+    std::vector<std::unique_ptr<sf::Texture>> pages;
+    for (auto i = 0u; i < pageCount; ++i)
+    {
+        pages.emplace_back(std::make_unique<sf::Texture>());
+        if (!pages.back()->loadFromFile(getPagePath(path, i)))
+        {
+            return false;
+        }
+        pages.back()->setSmooth(m_smooth);
+    }
+
+    m_pages.swap(pages);
+    m_entries.swap(entries);
+    return true;
+}
+
+const sf::Texture& TextureAtlas::getTexture(std::size_t page) const
+{
+    XY_ASSERT(page < m_pages.size(), "Page index out of range");
+    return *m_pages[page];
+}
+
+const TextureAtlas::Region* TextureAtlas::getRegion(const std::string& name) const
+{
+    auto result = m_entries.find(name);
+    return (result == m_entries.end()) ? nullptr : &result->second.region;
+}
+
+bool TextureAtlas::apply(Sprite& sprite, const std::string& name) const
+{
+    auto result = m_entries.find(name);
+    if (result == m_entries.end())
+    {
+        return false;
+    }
+
+    const auto& region = result->second.region;
+    const auto& texture = *m_pages[region.page];
+    if (sprite.getTexture() == &texture)
+    {
+        //already applied
+        return true;
+    }
+
+    const sf::Vector2f offset(static_cast<float>(region.bounds.left), static_cast<float>(region.bounds.top));
+
+    auto rect = sprite.getTextureRect();
+    rect.left += offset.x;
+    rect.top += offset.y;
+    sprite.setTexture(texture);
+    sprite.setTextureRect(rect);
+
+    auto& animations = sprite.getAnimations();
+    for (auto i = 0u; i < sprite.getAnimationCount(); ++i)
+    {
+        auto& anim = animations[i];
+        for (auto j = 0u; j < anim.frameCount; ++j)
+        {
+            anim.frames[j].left += offset.x;
+            anim.frames[j].top += offset.y;
+        }
+    }
+
+    return true;
+}
+
+bool TextureAtlas::apply(SpriteSheet& sheet) const
+{
+    const auto& name = sheet.getTexturePath();
+    if (m_entries.count(name) == 0)
+    {
+        Logger::log(name + " not found in texture atlas", Logger::Type::Warning);
+        return false;
+    }
+
+    for (auto& sprite : sheet.m_sprites)
+    {
+        apply(sprite.second, name);
+    }
+    return true;
+}